@@ -0,0 +1,25 @@
+// VoxelDensitySmoothingTest.cpp
+// Автотест раздельного фильтра сглаживания: совпадение с эталоном 3x3x3 в пределах Tolerance
+
+#include "Misc/AutomationTest.h"
+#include "VoxelDensitySmoothing.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelSmoothingToleranceTest, "VoxelWorld.Smoothing.Tolerance",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVoxelSmoothingToleranceTest::RunTest(const FString& Parameters)
+{
+    // Проходы 1..3 — диапазон SmoothingPasses мешера
+    for (int32 Passes = 1; Passes <= 3; Passes++)
+    {
+        const float MaxError = FVoxelDensitySmoothing::MeasureError(64, Passes);
+        TestTrue(FString::Printf(TEXT("%d pass(es): max error %g within %g"), Passes, MaxError, FVoxelDensitySmoothing::Tolerance),
+                 MaxError <= FVoxelDensitySmoothing::Tolerance);
+        AddInfo(FString::Printf(TEXT("%d pass(es): max error %g"), Passes, MaxError));
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,40 @@
+// VoxelPackedMeshTest.cpp
+// Автотест упакованного формата вершин: размер вершины и погрешности распаковки позиции, нормали и UV
+
+#include "Misc/AutomationTest.h"
+#include "VoxelPackedMesh.h"
+#include "VoxelChunkData.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelPackedMeshEncodingTest, "VoxelWorld.PackedMesh.Encoding",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVoxelPackedMeshEncodingTest::RunTest(const FString& Parameters)
+{
+    const FVoxelPackedMeshTestResult Result = FVoxelPackedMesh::RunSelfTest(65536);
+
+    // Полшага фиксированной точки (1/512 блока) плюс округление float
+    const float PositionTolerance = VoxelConstants::BlockSize / (2 * FVoxelPackedMesh::PositionUnitsPerBlock) + 1e-3f;
+    // Октаэдрическая нормаль 7 + 7 бит: около 1.9 градуса в худшем случае
+    const float NormalToleranceDeg = 2.5f;
+
+    TestEqual(TEXT("Bytes per vertex"), Result.BytesPerVertex, 12);
+    TestTrue(TEXT("Packed section memory is 12 bytes per vertex"), Result.PackedBytes <= (SIZE_T)Result.NumVertices * 12);
+    TestTrue(FString::Printf(TEXT("Position error %.4f cm within %.4f cm"), Result.MaxPositionError, PositionTolerance),
+             Result.MaxPositionError <= PositionTolerance);
+    TestTrue(FString::Printf(TEXT("Normal error %.2f deg within %.2f deg"), Result.MaxNormalErrorDeg, NormalToleranceDeg),
+             Result.MaxNormalErrorDeg <= NormalToleranceDeg);
+    // Углы граней лежат на сетке тайла — UV граней восстанавливаются точно
+    TestTrue(FString::Printf(TEXT("Block face UV error %.6f is zero"), Result.MaxFaceUVError), Result.MaxFaceUVError <= 1e-5f);
+    // UV сглаженной поверхности — от квантованной позиции: не больше погрешности позиции в тайлах
+    TestTrue(FString::Printf(TEXT("Smooth UV error %.6f within position error"), Result.MaxSmoothUVError),
+             Result.MaxSmoothUVError <= PositionTolerance / VoxelConstants::BlockSize);
+
+    AddInfo(FString::Printf(TEXT("%d vertices, %d bytes/vertex (was %d), max position error %.3f cm, max normal error %.2f deg"),
+                            Result.NumVertices, Result.BytesPerVertex, (int32)FVoxelPackedMesh::UnpackedVertexSize,
+                            Result.MaxPositionError, Result.MaxNormalErrorDeg));
+    return true;
+}
+
+#endif
@@ -0,0 +1,25 @@
+// VoxelRegionFileTest.cpp
+// Автотест формата регионов: запись и чтение 10000 синтетических чанков без расхождений
+
+#include "Misc/AutomationTest.h"
+#include "VoxelRegionFile.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoxelRegionRoundTripTest, "VoxelWorld.Region.RoundTrip",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVoxelRegionRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FVoxelRegionBenchmarkResult Result = FVoxelRegionStorage::RunBenchmark(10000);
+
+    TestEqual(TEXT("Chunks saved"), Result.NumSaved, Result.NumChunks);
+    TestEqual(TEXT("Chunks not loaded byte for byte"), Result.NumMismatches, 0);
+
+    AddInfo(FString::Printf(TEXT("%d chunks, %.2f MB raw -> %.2f MB on disk, write %.1f MB/s, read %.1f MB/s"),
+                            Result.NumChunks, Result.RawBytes / (1024.0 * 1024.0), Result.DiskBytes / (1024.0 * 1024.0),
+                            Result.GetWriteMBPerSecond(), Result.GetReadMBPerSecond()));
+    return true;
+}
+
+#endif
@@ -4,42 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
-#include "ProceduralMeshComponent.h"
+#include "Tasks/Task.h"
+#include "VoxelChunkData.h"
+#include "VoxelChunkMeshComponent.h"
+#include "VoxelChunkMesher.h"
+#include "VoxelTerrainGenerator.h"
+#include <atomic>
 #include "VoxelChunk.generated.h"
 
-namespace VoxelConstants
-{
-    constexpr float BlockSize = 80.0f;
-    constexpr float PlayerBlockSize = 20.0f;
-    constexpr float PlayerWidth = 78.0f;
-    constexpr float PlayerHeight = 158.0f;
-    constexpr int32 ChunkSizeX = 16;
-    constexpr int32 ChunkSizeY = 16;
-    constexpr int32 ChunkSizeZ = 32;
-    constexpr int32 RenderDistance = 8;
-    constexpr float InteractionDistance = 500.0f;
-
-    // FBM Noise parameters
-    constexpr float NoiseScale = 0.01f;
-    constexpr float HeightAmplitude = 15.0f;
-    constexpr float HeightBase = 7.5f;
-    constexpr int32 NoiseOctaves = 5;
-    constexpr float NoisePersistence = 0.05f;
-    constexpr float NoiseLacunarity = 2.5f;
-}
-
-USTRUCT()
-struct FSmallBlock
-{
-    GENERATED_BODY()
-
-    FIntVector Position;
-    FName BlockID;
-
-    FSmallBlock() : BlockID(NAME_None) {}
-    FSmallBlock(const FIntVector& Pos, FName InBlockID) : Position(Pos), BlockID(InBlockID) {}
-};
-
 USTRUCT()
 struct FWorldBlock
 {
@@ -50,25 +22,13 @@ struct FWorldBlock
     bool IsAir() const { return BlockID.IsNone() || BlockID == "Air"; }
 };
 
-// Структура для хранения данных меша одной секции (материала)
-struct FMeshSectionData
+// Результат фоновой сборки чанка
+struct FVoxelChunkBuildResult
 {
-    TArray<FVector> Vertices;
-    TArray<int32> Triangles;
-    TArray<FVector> Normals;
-    TArray<FVector2D> UVs;
-    TArray<FColor> Colors;
-    
-    void Reset()
-    {
-        Vertices.Empty();
-        Triangles.Empty();
-        Normals.Empty();
-        UVs.Empty();
-        Colors.Empty();
-    }
-    
-    bool IsEmpty() const { return Vertices.Num() == 0; }
+    // Сгенерированные блоки — только если сборка включала генерацию
+    TSharedPtr<FVoxelChunkData, ESPMode::ThreadSafe> GeneratedData;
+    FVoxelChunkMeshData Mesh;
+    bool bCancelled = false;
 };
 
 UCLASS()
@@ -79,21 +39,78 @@ class VOXELWORLD_API AVoxelChunk : public AActor
 public:
     AVoxelChunk();
 
-    void InitializeChunk(int32 ChunkX, int32 ChunkY);
+    // Привязать актор к данным чанка из FVoxelChunkStore и запустить фоновую сборку;
+    // bGenerateBlocks — данные новые и их нужно заполнить из шума
+    void InitializeChunk(int32 ChunkX, int32 ChunkY, const FVoxelChunkDataRef& InChunkData, bool bGenerateBlocks);
+
+    // Вернуть актор в пул менеджера: отменить сборку, отпустить данные, очистить меш,
+    // скрыть и выключить коллизию. Следующий InitializeChunk включает его обратно.
+    void ResetForPool();
+
+    // Блоки чанка заполнены (сгенерированы или взяты из хранилища) — можно читать и править
+    bool HasBlockData() const { return bHasBlockData; }
+    bool IsBuildInProgress() const { return BuildTask.IsValid(); }
+    // Фоновая сборка закончилась и ждёт CommitPendingBuild
+    bool IsBuildReady() const { return BuildTask.IsValid() && BuildTask.IsCompleted(); }
+
+    // Игровой поток: применить готовую сборку (блоки, меш, коллизия).
+    // Вызывает менеджер в рамках бюджета кадра.
+    void CommitPendingBuild();
 
     FName GetBlock(int32 X, int32 Y, int32 Z) const;
     void SetBlock(int32 X, int32 Y, int32 Z, FName BlockID);
     bool IsBlockSolid(int32 X, int32 Y, int32 Z) const;
 
-    void AddSmallBlock(const FIntVector& WorldSubBlockPos, FName BlockID);
+    // Доступ по runtime ID (UVoxelDatabase), без перевода FName.
+    // SetBlock/SetBlockRuntimeID — правки игрока, попадают в дельту правок чанка.
+    uint16 GetBlockRuntimeID(int32 X, int32 Y, int32 Z) const;
+    void SetBlockRuntimeID(int32 X, int32 Y, int32 Z, uint16 RuntimeID);
+
+    bool AddSmallBlock(const FIntVector& WorldSubBlockPos, FName BlockID);
     bool RemoveSmallBlock(const FIntVector& WorldSubBlockPos);
     bool HasSmallBlockAt(const FIntVector& WorldSubBlockPos) const;
     FName GetSmallBlockID(const FIntVector& WorldSubBlockPos) const;
-
-    void GenerateMesh();
-    void MarkDirty() { bIsDirty = true; }
+    // Есть ли маленькие блоки в большой ячейке (X,Y,Z) — одна проверка маски
+    bool HasSmallBlocksInCell(int32 X, int32 Y, int32 Z) const;
+
+    // Перестроить меш: чанк попадает в набор грязных чанков менеджера,
+    // который раз в кадр запускает одну сборку на все правки чанка
+    void MarkDirty();
+    // Запустить сборку по накопленным правкам. false — сейчас нельзя (идёт сборка
+    // или блоки ещё не сгенерированы), менеджер повторит в следующем кадре.
+    bool StartPendingRebuild();
     FIntVector2 GetChunkCoords() const { return ChunkCoords; }
 
+    // Детализация сглаженного меша (0 — полная, 1 и 2 — шаг 2 и 4 блока) и юбки по краям,
+    // когда у соседа другой LOD. Изменение ставит чанк на перестройку; blocky-меш LOD не меняет.
+    void SetMeshLOD(int32 InLODLevel, bool bInSkirts);
+    int32 GetMeshLOD() const { return LODLevel; }
+
+    // Память под большие блоки: текущая палитра и прежний плоский TArray<FName>
+    SIZE_T GetBlockMemoryUsage() const { return ChunkData->GetBlockMemoryUsage(); }
+    int32 GetNumUniformSections() const { return ChunkData->GetNumUniformSections(); }
+    SIZE_T GetSmallBlockMemoryUsage() const { return ChunkData->SmallBlocks.GetAllocatedSize(); }
+    int32 GetNumSmallBlocks() const { return ChunkData->SmallBlocks.Num(); }
+    static SIZE_T GetLegacyBlockMemoryUsage()
+    {
+        return sizeof(FName) * VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY * VoxelConstants::ChunkSizeZ;
+    }
+
+    const FVoxelMeshStats& GetMeshStats() const { return MeshStats; }
+    // Упакованный меш в компоненте (CPU), байты
+    SIZE_T GetMeshMemoryUsage() const { return MeshComponent->GetPackedMemoryUsage(); }
+
+    // Только для чтения в игровом потоке (фартук соседей, статистика)
+    const FVoxelChunkData& GetChunkData() const { return *ChunkData; }
+    // Последняя запущенная сборка видела соседа с этой стороны (FVoxelChunkApron::ESide)
+    bool HasApronSide(int32 Side) const { return (BuildApronSides >> Side) & 1u; }
+
+    // ======== Blocky terrain ========
+    
+    // Сливать соседние грани с одинаковыми материалом и цветом в прямоугольники
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Blocky")
+    bool bUseGreedyMeshing = true;
+
     // ======== Smooth terrain (Marching Cubes) ========
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Smooth")
@@ -107,68 +124,57 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Smooth", meta = (ClampMin = "1", ClampMax = "8"))
     int32 SmoothSurfaceDepth = 3;
 
+    // Naive Surface Nets вместо Marching Cubes: вершина на ячейку и квады между ними —
+    // примерно вдвое меньше треугольников и без тонких треугольников в коллизии
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel|Smooth")
+    bool bUseSurfaceNets = false;
+
 protected:
     virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     UPROPERTY(VisibleAnywhere)
-    UProceduralMeshComponent* MeshComponent;
+    UVoxelChunkMeshComponent* MeshComponent;
 
-    TArray<FName> Blocks;
-    TArray<FSmallBlock> SmallBlocks;
+    // Блоки чанка; принадлежат FVoxelChunkStore менеджера и переживают актор
+    FVoxelChunkDataRef ChunkData = MakeShared<FVoxelChunkData, ESPMode::ThreadSafe>();
 
     FIntVector2 ChunkCoords;
     bool bIsDirty = false;
+    FVoxelMeshStats MeshStats;
+
+    // Runtime ID блоков террейна, разрешаются один раз в InitializeChunk
+    FVoxelTerrainGenerator Terrain;
+
+    bool bHasBlockData = false;
+    // FVoxelChunkApron::PresentSides последней запущенной сборки
+    uint8 BuildApronSides = 0;
+
+    // Выставляет менеджер по расстоянию до игрока (SetMeshLOD)
+    int32 LODLevel = 0;
+    bool bLODSkirts = false;
+
+    // Текущая фоновая сборка и её флаг отмены (задача проверяет его между этапами)
+    UE::Tasks::TTask<FVoxelChunkBuildResult> BuildTask;
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> BuildCancelFlag;
+
+    // Запустить генерацию (если нужно) и построение меша в UE::Tasks
+    void StartBuild(bool bGenerateBlocks);
+    void CancelBuild();
+    // Игровой поток: принять сгенерированные блоки и выставить меш
+    void CommitBuild(FVoxelChunkBuildResult& Result);
+    // Упакованные секции переезжают в компонент
+    void ApplyMeshData(FVoxelChunkMeshData& MeshData);
 
-    int32 GetBlockIndex(int32 X, int32 Y, int32 Z) const;
-    void GenerateBlocksData();
-    float GetFBMNoise(float X, float Y) const;
-    
-    // === Blocky mesh (оригинальная система) ===
-    void GenerateBlockyMesh(TMap<int32, FMeshSectionData>& MeshSections);
-    void AddFaceToSection(TMap<int32, FMeshSectionData>& Sections, int32 MaterialIndex,
-                          const FVector& Position, const FVector& Normal, FName BlockID, float Size);
-    
-    // === Smooth mesh (Marching Cubes) ===
-    
-    TArray<float> DensityField;
-    TArray<FName> DensityBlockIDs;
-    
-    static constexpr int32 DensityPadding = 1;
-    int32 DensitySizeX() const { return VoxelConstants::ChunkSizeX + 1 + DensityPadding * 2; }
-    int32 DensitySizeY() const { return VoxelConstants::ChunkSizeY + 1 + DensityPadding * 2; }
-    int32 DensitySizeZ() const { return VoxelConstants::ChunkSizeZ + 1; }
-    int32 DensityIndex(int32 X, int32 Y, int32 Z) const;
-    float GetDensity(int32 X, int32 Y, int32 Z) const;
-    
-    void BuildDensityField();
-    void SmoothDensityField();
-    void GenerateSmoothMesh(TMap<int32, FMeshSectionData>& MeshSections);
-    
-    FName GetDominantBlockAt(int32 X, int32 Y, int32 Z) const;
-    FVector InterpolateEdge(const FVector& P1, const FVector& P2, float V1, float V2) const;
-    
-    // Получить блок по мировым координатам (с доступом к соседним чанкам)
-    bool IsWorldBlockSolid(int32 WorldBlockX, int32 WorldBlockY, int32 WorldBlockZ) const;
-    FName GetWorldBlock(int32 WorldBlockX, int32 WorldBlockY, int32 WorldBlockZ) const;
-    
-    // FIX #2: Проверка, поставлен ли блок игроком (не из terrain generation)
-    bool IsPlayerPlacedBlock(int32 LocalX, int32 LocalY, int32 LocalZ) const;
-    
-    // === Общие утилиты ===
-    FColor GetBlockColor(FName BlockID) const;
-    int32 GetBlockMaterialIndex(FName BlockID) const;
     void ApplyMaterialsToMesh();
 
     FIntVector WorldToLocalSubBlock(const FIntVector& WorldPos) const;
     bool IsSubBlockInChunk(const FIntVector& LocalPos) const;
-    int32 FindSmallBlockIndex(const FIntVector& WorldPos) const;
+    
+    // Локальная позиция маленького блока -> индекс большой ячейки + бит в её маске
+    void GetSmallBlockCell(const FIntVector& LocalPos, int32& OutCellIndex, int32& OutBit) const;
     
     UPROPERTY()
     TMap<int32, UMaterialInterface*> SectionMaterials;
-
-    // ======== Marching Cubes таблицы ========
-    static const int32 EdgeTable[256];
-    static const int32 TriTable[256][16];
 };
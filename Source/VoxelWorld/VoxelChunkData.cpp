@@ -0,0 +1,358 @@
+// VoxelChunkData.cpp
+
+#include "VoxelChunkData.h"
+#include "VoxelDatabase.h"
+
+FVoxelChunkData::FVoxelChunkData()
+{
+    for (FVoxelPaletteStorage& Section : Sections)
+    {
+        Section.Init(VoxelConstants::SectionVolume);
+    }
+}
+
+// ============================================================
+// Block access
+// ============================================================
+
+uint16 FVoxelChunkData::GetBlock(int32 X, int32 Y, int32 Z) const
+{
+    if (!IsInChunk(X, Y, Z))
+    {
+        return FVoxelBlockTables::AirID;
+    }
+
+    return GetBlockAtIndex(GetBlockIndex(X, Y, Z));
+}
+
+void FVoxelChunkData::SetBlock(int32 X, int32 Y, int32 Z, uint16 RuntimeID)
+{
+    if (!IsInChunk(X, Y, Z))
+    {
+        return;
+    }
+
+    const int32 Index = GetBlockIndex(X, Y, Z);
+    Sections[Index / VoxelConstants::SectionVolume].Set(Index % VoxelConstants::SectionVolume, RuntimeID);
+
+    uint32& ColumnMask = ColumnSolidMasks[GetColumnIndex(X, Y)];
+    if (RuntimeID != FVoxelBlockTables::AirID)
+        ColumnMask |= (1u << Z);
+    else
+        ColumnMask &= ~(1u << Z);
+}
+
+void FVoxelChunkData::EditBlock(int32 X, int32 Y, int32 Z, uint16 RuntimeID)
+{
+    if (!IsInChunk(X, Y, Z))
+    {
+        return;
+    }
+
+    SetBlock(X, Y, Z, RuntimeID);
+    ColumnEditMasks[GetColumnIndex(X, Y)] |= (1u << Z);
+    bNeedsSave = true;
+}
+
+bool FVoxelChunkData::IsBlockSolid(int32 X, int32 Y, int32 Z) const
+{
+    if (Z < 0 || Z >= VoxelConstants::ChunkSizeZ) return false;
+    return (GetColumnMask(X, Y) >> Z) & 1u;
+}
+
+uint32 FVoxelChunkData::GetColumnMask(int32 X, int32 Y, const FVoxelChunkApron* Apron) const
+{
+    const bool bInsideX = X >= 0 && X < VoxelConstants::ChunkSizeX;
+    const bool bInsideY = Y >= 0 && Y < VoxelConstants::ChunkSizeY;
+    if (!bInsideX || !bInsideY)
+    {
+        if (!Apron || !FVoxelChunkApron::IsInApron(X, Y)) return 0;
+        return Apron->SolidMasks[FVoxelChunkApron::GetIndex(X, Y)];
+    }
+    return ColumnSolidMasks[GetColumnIndex(X, Y)];
+}
+
+void FVoxelChunkData::GetColumnFaceMasks(int32 X, int32 Y, uint32 OutFaceMasks[6], const FVoxelChunkApron* Apron) const
+{
+    const uint32 Solid = ColumnSolidMasks[GetColumnIndex(X, Y)];
+
+    // Грань видна, если соседняя ячейка пуста. Сдвиг вверх/вниз по столбцу
+    // выталкивает за Z=31 / Z=0 нули — граница мира по Z считается воздухом.
+    OutFaceMasks[0] = Solid & ~(Solid >> 1);
+    OutFaceMasks[1] = Solid & ~(Solid << 1);
+    OutFaceMasks[2] = Solid & ~GetColumnMask(X + 1, Y, Apron);
+    OutFaceMasks[3] = Solid & ~GetColumnMask(X - 1, Y, Apron);
+    OutFaceMasks[4] = Solid & ~GetColumnMask(X, Y + 1, Apron);
+    OutFaceMasks[5] = Solid & ~GetColumnMask(X, Y - 1, Apron);
+}
+
+bool FVoxelChunkData::HasEdits() const
+{
+    if (!SmallBlocks.IsEmpty()) return true;
+    for (uint32 Mask : ColumnEditMasks)
+    {
+        if (Mask) return true;
+    }
+    return false;
+}
+
+int32 FVoxelChunkData::GetNumEditedBlocks() const
+{
+    int32 Count = 0;
+    for (uint32 Mask : ColumnEditMasks)
+    {
+        Count += FMath::CountBits(Mask);
+    }
+    return Count;
+}
+
+// ============================================================
+// Sections
+// ============================================================
+
+bool FVoxelChunkData::IsSectionEmpty(int32 SectionIndex) const
+{
+    const FVoxelPaletteStorage& Section = Sections[SectionIndex];
+    return Section.IsUniform() && Section.GetUniformValue() == FVoxelBlockTables::AirID;
+}
+
+bool FVoxelChunkData::IsSectionEnclosed(int32 SectionIndex, const FVoxelChunkApron* Apron) const
+{
+    const FVoxelPaletteStorage& Section = Sections[SectionIndex];
+    if (!Section.IsUniform() || Section.GetUniformValue() == FVoxelBlockTables::AirID) return false;
+
+    // Граница мира по Z считается воздухом — крайние секции всегда имеют грани
+    if (SectionIndex == 0 || SectionIndex == VoxelConstants::NumSectionsZ - 1) return false;
+
+    // Внутри чанка: секция плюс слой над и под ней; соседние столбцы: только сама секция.
+    // Столбцы за границей чанка берутся из фартука; без соседа это воздух.
+    const uint32 SectionBits = GetSectionZBits(SectionIndex);
+    const uint32 BandBits = SectionBits | (SectionBits << 1) | (SectionBits >> 1);
+    for (int32 Y = -1; Y <= VoxelConstants::ChunkSizeY; Y++)
+    {
+        for (int32 X = -1; X <= VoxelConstants::ChunkSizeX; X++)
+        {
+            const bool bInsideX = X >= 0 && X < VoxelConstants::ChunkSizeX;
+            const bool bInsideY = Y >= 0 && Y < VoxelConstants::ChunkSizeY;
+            if (!bInsideX && !bInsideY) continue; // углы не касаются граней
+
+            const uint32 Required = (bInsideX && bInsideY) ? BandBits : SectionBits;
+            if ((GetColumnMask(X, Y, Apron) & Required) != Required) return false;
+        }
+    }
+    return true;
+}
+
+uint32 FVoxelChunkData::GetMeshedZMask(const FVoxelChunkApron* Apron) const
+{
+    uint32 Mask = 0;
+    for (int32 SectionIndex = 0; SectionIndex < VoxelConstants::NumSectionsZ; SectionIndex++)
+    {
+        if (!IsSectionEmpty(SectionIndex) && !IsSectionEnclosed(SectionIndex, Apron))
+        {
+            Mask |= GetSectionZBits(SectionIndex);
+        }
+    }
+    return Mask;
+}
+
+// ============================================================
+// Small blocks
+// ============================================================
+
+uint64 FVoxelChunkData::GetCellOccupancy(int32 X, int32 Y, int32 Z, const FVoxelChunkApron* Apron) const
+{
+    if (!IsInChunk(X, Y, Z))
+    {
+        if (Z < 0 || Z >= VoxelConstants::ChunkSizeZ) return 0;
+        return ((GetColumnMask(X, Y, Apron) >> Z) & 1u) ? ~0ull : 0;
+    }
+    if (IsBlockSolid(X, Y, Z)) return ~0ull;
+    return SmallBlocks.GetCellMask(GetBlockIndex(X, Y, Z));
+}
+
+// ============================================================
+// Memory
+// ============================================================
+
+SIZE_T FVoxelChunkData::GetBlockMemoryUsage() const
+{
+    SIZE_T Size = 0;
+    for (const FVoxelPaletteStorage& Section : Sections)
+    {
+        Size += Section.GetAllocatedSize();
+    }
+    return Size;
+}
+
+int32 FVoxelChunkData::GetNumUniformSections() const
+{
+    int32 Count = 0;
+    for (const FVoxelPaletteStorage& Section : Sections)
+    {
+        Count += Section.IsUniform() ? 1 : 0;
+    }
+    return Count;
+}
+
+SIZE_T FVoxelChunkData::GetAllocatedSize() const
+{
+    return sizeof(FVoxelChunkData) + GetBlockMemoryUsage() + SmallBlocks.GetAllocatedSize();
+}
+
+// ============================================================
+// Serialization
+// ============================================================
+
+void FVoxelChunkData::Serialize(FArchive& Ar)
+{
+    UVoxelDatabase* DB = UVoxelDatabase::Get();
+    if (!DB)
+    {
+        Ar.SetError();
+        return;
+    }
+
+    if (Ar.IsSaving())
+    {
+        // Таблица имён — только блоки этого чанка; индекс в ней заменяет runtime ID
+        const int32 NumRuntimeIDs = DB->GetBlockTables().Num();
+        TArray<uint16> FileIndices;
+        FileIndices.Init(MAX_uint16, NumRuntimeIDs);
+        TArray<FString> BlockNames;
+        auto AddRuntimeID = [&](uint16 RuntimeID)
+        {
+            if (RuntimeID < NumRuntimeIDs && FileIndices[RuntimeID] == MAX_uint16)
+            {
+                FileIndices[RuntimeID] = (uint16)BlockNames.Num();
+                BlockNames.Add(DB->GetBlockIDByRuntimeID(RuntimeID).ToString());
+            }
+        };
+        for (const FVoxelPaletteStorage& Section : Sections)
+        {
+            for (uint16 RuntimeID : Section.GetPaletteValues())
+            {
+                AddRuntimeID(RuntimeID);
+            }
+        }
+        SmallBlocks.ForEachPaletteValue(AddRuntimeID);
+        Ar << BlockNames;
+
+        // Пишутся копии с индексами таблицы: данные чанка при сохранении не меняются.
+        // Runtime ID без строки в таблицах не записать — это ошибка, а не воздух.
+        for (const FVoxelPaletteStorage& Section : Sections)
+        {
+            FVoxelPaletteStorage FileSection = Section;
+            if (!FileSection.RemapValues(FileIndices))
+            {
+                Ar.SetError();
+                return;
+            }
+            Ar << FileSection;
+        }
+        for (uint32& EditMask : ColumnEditMasks)
+        {
+            Ar << EditMask;
+        }
+        FVoxelSmallBlockStorage FileSmallBlocks = SmallBlocks;
+        if (!FileSmallBlocks.RemapValues(FileIndices))
+        {
+            Ar.SetError();
+            return;
+        }
+        Ar << FileSmallBlocks;
+        return;
+    }
+
+    TArray<FString> BlockNames;
+    Ar << BlockNames;
+    for (FVoxelPaletteStorage& Section : Sections)
+    {
+        Ar << Section;
+    }
+    for (uint32& EditMask : ColumnEditMasks)
+    {
+        Ar << EditMask;
+    }
+    Ar << SmallBlocks;
+
+    if (!Ar.IsError())
+    {
+        bool bValid = BlockNames.Num() <= MAX_uint16;
+        for (const FVoxelPaletteStorage& Section : Sections)
+        {
+            bValid &= Section.GetNumEntries() == VoxelConstants::SectionVolume;
+        }
+
+        constexpr int32 ChunkVolume = VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY * VoxelConstants::ChunkSizeZ;
+        SmallBlocks.ForEachCell([&bValid](int32 CellIndex, const FVoxelSmallBlockCell&)
+        {
+            bValid &= CellIndex >= 0 && CellIndex < ChunkVolume;
+        });
+
+        if (!bValid)
+        {
+            Ar.SetError();
+            return;
+        }
+
+        // Индексы таблицы -> текущие runtime ID; значение без строки в таблице — повреждённые данные
+        TArray<uint16> RuntimeIDs;
+        RuntimeIDs.Reserve(BlockNames.Num());
+        for (const FString& BlockName : BlockNames)
+        {
+            RuntimeIDs.Add(DB->GetOrAddRuntimeID(FName(*BlockName)));
+        }
+        for (FVoxelPaletteStorage& Section : Sections)
+        {
+            bValid &= Section.RemapValues(RuntimeIDs);
+        }
+        bValid &= SmallBlocks.RemapValues(RuntimeIDs);
+        if (!bValid)
+        {
+            Ar.SetError();
+            return;
+        }
+
+        RebuildColumnMasks();
+        bNeedsSave = false;
+    }
+}
+
+void FVoxelChunkData::RebuildColumnMasks()
+{
+    FMemory::Memzero(ColumnSolidMasks, sizeof(ColumnSolidMasks));
+
+    for (int32 SectionIndex = 0; SectionIndex < VoxelConstants::NumSectionsZ; SectionIndex++)
+    {
+        const FVoxelPaletteStorage& Section = Sections[SectionIndex];
+        const int32 ZStart = SectionIndex * VoxelConstants::SectionSizeZ;
+
+        // Однородная секция: сразу весь диапазон Z во всех столбцах
+        if (Section.IsUniform())
+        {
+            if (Section.GetUniformValue() != FVoxelBlockTables::AirID)
+            {
+                for (uint32& ColumnMask : ColumnSolidMasks)
+                {
+                    ColumnMask |= GetSectionZBits(SectionIndex);
+                }
+            }
+            continue;
+        }
+
+        for (int32 Z = ZStart; Z < ZStart + VoxelConstants::SectionSizeZ; Z++)
+        {
+            for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y++)
+            {
+                for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X++)
+                {
+                    if (GetBlockAtIndex(GetBlockIndex(X, Y, Z)) != FVoxelBlockTables::AirID)
+                    {
+                        ColumnSolidMasks[GetColumnIndex(X, Y)] |= (1u << Z);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,202 @@
+// VoxelChunkData.h
+// Воксельные данные чанка без UObject: живут дольше актора чанка (см. FVoxelChunkStore)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelPaletteStorage.h"
+#include "VoxelSmallBlockStorage.h"
+
+namespace VoxelConstants
+{
+    constexpr float BlockSize = 80.0f;
+    constexpr float PlayerBlockSize = 20.0f;
+    constexpr float PlayerWidth = 78.0f;
+    constexpr float PlayerHeight = 158.0f;
+    constexpr int32 ChunkSizeX = 16;
+    constexpr int32 ChunkSizeY = 16;
+    constexpr int32 ChunkSizeZ = 32;
+    constexpr int32 SubBlocksPerBlock = 4; // BlockSize / PlayerBlockSize
+    constexpr int32 SectionSizeZ = 8;      // Вертикальная секция чанка 16x16x8
+    constexpr int32 NumSectionsZ = ChunkSizeZ / SectionSizeZ;
+    constexpr int32 SectionVolume = ChunkSizeX * ChunkSizeY * SectionSizeZ;
+    constexpr int32 RenderDistance = 8;
+    constexpr float InteractionDistance = 500.0f;
+
+    // FBM Noise parameters
+    constexpr float NoiseScale = 0.01f;
+    constexpr float HeightAmplitude = 15.0f;
+    constexpr float HeightBase = 7.5f;
+    constexpr int32 NoiseOctaves = 5;
+    constexpr float NoisePersistence = 0.05f;
+    constexpr float NoiseLacunarity = 2.5f;
+}
+
+// Столбец чанка хранится битовой маской uint32
+static_assert(VoxelConstants::ChunkSizeZ == 32, "Column masks assume 32 blocks per column");
+static_assert(VoxelConstants::ChunkSizeZ % VoxelConstants::SectionSizeZ == 0, "Chunk height must be whole sections");
+// Маленькие блоки одной большой ячейки (4x4x4) хранятся маской uint64
+static_assert(VoxelConstants::SubBlocksPerBlock == FVoxelSmallBlockStorage::CellSize, "Small block cell must be 4x4x4");
+
+// "Фартук" чанка: столбцы восьми соседних чанков вокруг него, в локальных координатах чанка.
+// Полоса в PadLow столбцов со стороны -X/-Y и PadHigh со стороны +X/+Y — ровно столько
+// читает поле плотности Marching Cubes (его вершины выходят за чанк); блочному мешу
+// нужны только столбцы вплотную к граням. Снимается в игровом потоке перед сборкой меша.
+// Клетки самого чанка и соседей, которые не были загружены, остаются нулевыми (воздух).
+struct FVoxelChunkApron
+{
+    // Сначала соседи по граням (порядок граней +X, -X, +Y, -Y в GetColumnFaceMasks), затем угловые
+    enum ESide : int32 { PosX, NegX, PosY, NegY, PosXPosY, NegXPosY, PosXNegY, NegXNegY, NumSides };
+    static constexpr int32 NumFaceSides = 4;
+
+    static constexpr int32 PadLow = 1;
+    static constexpr int32 PadHigh = 2;
+    static constexpr int32 SizeX = VoxelConstants::ChunkSizeX + PadLow + PadHigh;
+    static constexpr int32 SizeY = VoxelConstants::ChunkSizeY + PadLow + PadHigh;
+
+    // Маски столбцов, бит Z = блок не воздух
+    uint32 SolidMasks[SizeX * SizeY] = {};
+    // Большие блоки, поставленные игроком (правки & твёрдые), как FVoxelChunkData::IsPlayerPlacedBlock
+    uint32 PlayerPlacedMasks[SizeX * SizeY] = {};
+    // Бит стороны = сосед был загружен
+    uint8 PresentSides = 0;
+
+    bool HasSide(int32 Side) const { return (PresentSides >> Side) & 1u; }
+
+    static bool IsInApron(int32 X, int32 Y)
+    {
+        return X >= -PadLow && X < VoxelConstants::ChunkSizeX + PadHigh &&
+               Y >= -PadLow && Y < VoxelConstants::ChunkSizeY + PadHigh;
+    }
+    static int32 GetIndex(int32 X, int32 Y) { return (X + PadLow) + (Y + PadLow) * SizeX; }
+
+    static FIntPoint GetSideOffset(int32 Side)
+    {
+        static constexpr int32 Offsets[NumSides][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1} };
+        return FIntPoint(Offsets[Side][0], Offsets[Side][1]);
+    }
+    // Сторона по смещению соседа (-1..1); (0, 0) — сам чанк, INDEX_NONE
+    static int32 GetSideForOffset(int32 DX, int32 DY)
+    {
+        static constexpr int32 Sides[9] = { NegXNegY, NegY, PosXNegY, NegX, INDEX_NONE, PosX, NegXPosY, PosY, PosXPosY };
+        return Sides[(DX + 1) + (DY + 1) * 3];
+    }
+    // Сторона, с которой сосед видит нас
+    static int32 GetOppositeSide(int32 Side)
+    {
+        const FIntPoint Offset = GetSideOffset(Side);
+        return GetSideForOffset(-Offset.X, -Offset.Y);
+    }
+    // Какому соседу принадлежит локальный столбец (X, Y); внутри чанка — INDEX_NONE
+    static int32 GetSideAt(int32 X, int32 Y)
+    {
+        return GetSideForOffset(X < 0 ? -1 : (X >= VoxelConstants::ChunkSizeX ? 1 : 0),
+                                Y < 0 ? -1 : (Y >= VoxelConstants::ChunkSizeY ? 1 : 0));
+    }
+};
+
+// Блоки одного чанка: секции больших блоков, маски столбцов и маленькие блоки.
+// Координаты локальные; всё, что за пределами чанка, читается как воздух,
+// если методу не передан фартук с соседними столбцами.
+struct VOXELWORLD_API FVoxelChunkData
+{
+    FVoxelChunkData();
+
+    // Большие блоки по вертикальным секциям 16x16x8 (индекс секции = Z / SectionSizeZ).
+    // Однородная секция (весь воздух или весь камень) хранит одно значение.
+    FVoxelPaletteStorage Sections[VoxelConstants::NumSectionsZ];
+
+    // Маска заполненности каждого столбца (X,Y): бит Z = блок не воздух.
+    // ChunkSizeZ == 32, поэтому столбец ровно помещается в uint32.
+    uint32 ColumnSolidMasks[VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY] = {};
+
+    // Маленькие блоки: маска 4x4x4 на каждую занятую большую ячейку + палитра ID
+    FVoxelSmallBlockStorage SmallBlocks;
+
+    // Дельта правок игрока поверх процедурной генерации, по столбцам как ColumnSolidMasks:
+    // бит Z = большой блок ставил или убирал игрок. Маленькие блоки — всегда правки игрока.
+    uint32 ColumnEditMasks[VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY] = {};
+
+    // Есть правки, ещё не записанные на диск (не сериализуется)
+    bool bNeedsSave = false;
+
+    static int32 GetBlockIndex(int32 X, int32 Y, int32 Z)
+    {
+        return X + Y * VoxelConstants::ChunkSizeX + Z * VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY;
+    }
+    static int32 GetColumnIndex(int32 X, int32 Y) { return X + Y * VoxelConstants::ChunkSizeX; }
+    static bool IsInChunk(int32 X, int32 Y, int32 Z)
+    {
+        return X >= 0 && X < VoxelConstants::ChunkSizeX &&
+               Y >= 0 && Y < VoxelConstants::ChunkSizeY &&
+               Z >= 0 && Z < VoxelConstants::ChunkSizeZ;
+    }
+
+    // Индекс блока (GetBlockIndex) -> секция и позиция в ней
+    FORCEINLINE uint16 GetBlockAtIndex(int32 Index) const
+    {
+        return Sections[Index / VoxelConstants::SectionVolume].Get(Index % VoxelConstants::SectionVolume);
+    }
+
+    // Runtime ID блока; за пределами чанка — воздух
+    uint16 GetBlock(int32 X, int32 Y, int32 Z) const;
+    // Записать блок и обновить маску столбца (генерация — без отметки в дельте правок)
+    void SetBlock(int32 X, int32 Y, int32 Z, uint16 RuntimeID);
+    // Правка игрока: SetBlock + отметка в ColumnEditMasks
+    void EditBlock(int32 X, int32 Y, int32 Z, uint16 RuntimeID);
+    bool IsBlockSolid(int32 X, int32 Y, int32 Z) const;
+
+    bool IsBlockEdited(int32 X, int32 Y, int32 Z) const
+    {
+        return IsInChunk(X, Y, Z) && ((ColumnEditMasks[GetColumnIndex(X, Y)] >> Z) & 1u);
+    }
+    // Блок поставлен игроком: правленый и не воздух
+    bool IsPlayerPlacedBlock(int32 X, int32 Y, int32 Z) const
+    {
+        if (!IsInChunk(X, Y, Z)) return false;
+        const int32 Column = GetColumnIndex(X, Y);
+        return ((ColumnEditMasks[Column] & ColumnSolidMasks[Column]) >> Z) & 1u;
+    }
+    // Есть ли что сохранять поверх процедурной генерации
+    bool HasEdits() const;
+    int32 GetNumEditedBlocks() const;
+
+    // Маска столбца; за пределами чанка — столбец из фартука, если он есть, иначе 0 (воздух)
+    uint32 GetColumnMask(int32 X, int32 Y, const FVoxelChunkApron* Apron = nullptr) const;
+
+    // Маски видимых граней столбца (бит Z) в порядке +Z, -Z, +X, -X, +Y, -Y.
+    // С фартуком грани на стыке с твёрдыми блоками соседа не выдаются.
+    void GetColumnFaceMasks(int32 X, int32 Y, uint32 OutFaceMasks[6], const FVoxelChunkApron* Apron = nullptr) const;
+
+    static uint32 GetSectionZBits(int32 SectionIndex)
+    {
+        return ((1u << VoxelConstants::SectionSizeZ) - 1) << (SectionIndex * VoxelConstants::SectionSizeZ);
+    }
+    bool IsSectionEmpty(int32 SectionIndex) const;
+    // Однородно твёрдая секция, все соседние слои и столбцы которой тоже твёрдые — граней нет
+    bool IsSectionEnclosed(int32 SectionIndex, const FVoxelChunkApron* Apron = nullptr) const;
+    // Биты Z, которые нужно обходить при построении меша (пустые и закрытые секции пропускаются)
+    uint32 GetMeshedZMask(const FVoxelChunkApron* Apron = nullptr) const;
+
+    // Заполненность ячейки 4x4x4: большой блок = все биты, иначе маска маленьких блоков.
+    // Ячейка соседа из фартука — все биты, если там большой блок (маленькие блоки в фартук не входят).
+    uint64 GetCellOccupancy(int32 X, int32 Y, int32 Z, const FVoxelChunkApron* Apron = nullptr) const;
+
+    // Память под большие блоки (палитры секций)
+    SIZE_T GetBlockMemoryUsage() const;
+    int32 GetNumUniformSections() const;
+
+    // Полный объём данных чанка в памяти (для бюджета FVoxelChunkStore)
+    SIZE_T GetAllocatedSize() const;
+
+    // Таблица имён блоков, секции, дельта правок и маленькие блоки. Маски заполненности не пишутся —
+    // после загрузки они восстанавливаются из секций. Палитры в файле — индексы в таблице имён,
+    // а не runtime ID: те зависят от порядка регистрации блоков в UVoxelDatabase.
+    // Только game thread: загрузка назначает runtime ID через UVoxelDatabase::GetOrAddRuntimeID.
+    void Serialize(FArchive& Ar);
+
+    // Пересчитать ColumnSolidMasks по содержимому секций
+    void RebuildColumnMasks();
+};
+
+typedef TSharedRef<FVoxelChunkData, ESPMode::ThreadSafe> FVoxelChunkDataRef;
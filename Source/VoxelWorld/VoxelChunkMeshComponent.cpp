@@ -0,0 +1,271 @@
+// VoxelChunkMeshComponent.cpp
+
+#include "VoxelChunkMeshComponent.h"
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "MaterialDomain.h"
+#include "MaterialShared.h"
+#include "Materials/Material.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "PrimitiveSceneProxy.h"
+#include "PrimitiveViewRelevance.h"
+#include "SceneInterface.h"
+#include "StaticMeshResources.h"
+
+// ============================================================
+// Scene proxy
+// ============================================================
+
+// Буферы одной секции на GPU. Упакованные вершины распаковываются в стандартный формат
+// FLocalVertexFactory: чтение 16-битных позиций в шейдере требует своей vertex factory.
+struct FVoxelChunkProxySection
+{
+    FStaticMeshVertexBuffers VertexBuffers;
+    FDynamicMeshIndexBuffer32 IndexBuffer;
+    FLocalVertexFactory VertexFactory;
+    UMaterialInterface* Material = nullptr;
+
+    FVoxelChunkProxySection(ERHIFeatureLevel::Type FeatureLevel)
+        : VertexFactory(FeatureLevel, "FVoxelChunkProxySection")
+    {
+    }
+};
+
+class FVoxelChunkSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+    FVoxelChunkSceneProxy(UVoxelChunkMeshComponent* Component)
+        : FPrimitiveSceneProxy(Component)
+        , MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+    {
+        const ERHIFeatureLevel::Type FeatureLevel = GetScene().GetFeatureLevel();
+
+        for (const auto& Pair : Component->GetSections())
+        {
+            const FVoxelPackedMeshSection& Packed = Pair.Value;
+            if (Packed.IsEmpty()) continue;
+
+            TUniquePtr<FVoxelChunkProxySection> Section = MakeUnique<FVoxelChunkProxySection>(FeatureLevel);
+
+            // Тангенсы не хранятся — как у UProceduralMeshComponent без тангенсов
+            TArray<FDynamicMeshVertex> Vertices;
+            Vertices.Reserve(Packed.Vertices.Num());
+            for (const FVoxelPackedVertex& Vertex : Packed.Vertices)
+            {
+                Vertices.Emplace(FVoxelPackedMesh::DecodePosition(Vertex), FVector3f(1, 0, 0),
+                                 FVoxelPackedMesh::DecodeNormal(Vertex), FVoxelPackedMesh::DecodeUV(Vertex), Vertex.Color);
+            }
+            Section->IndexBuffer.Indices = Packed.Indices;
+
+            Section->VertexBuffers.InitFromDynamicVertex(&Section->VertexFactory, Vertices);
+            BeginInitResource(&Section->IndexBuffer);
+
+            Section->Material = Component->GetMaterial(Pair.Key);
+            if (!Section->Material)
+            {
+                Section->Material = UMaterial::GetDefaultMaterial(MD_Surface);
+            }
+            Sections.Add(MoveTemp(Section));
+        }
+    }
+
+    virtual ~FVoxelChunkSceneProxy() override
+    {
+        for (const TUniquePtr<FVoxelChunkProxySection>& Section : Sections)
+        {
+            Section->VertexBuffers.PositionVertexBuffer.ReleaseResource();
+            Section->VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+            Section->VertexBuffers.ColorVertexBuffer.ReleaseResource();
+            Section->IndexBuffer.ReleaseResource();
+            Section->VertexFactory.ReleaseResource();
+        }
+    }
+
+    virtual SIZE_T GetTypeHash() const override
+    {
+        static size_t UniquePointer;
+        return reinterpret_cast<size_t>(&UniquePointer);
+    }
+
+    // Меш чанка меняется только пересозданием proxy — рисуется как статика,
+    // команды отрисовки кэшируются сценой, а не собираются каждый кадр
+    virtual void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
+    {
+        for (const TUniquePtr<FVoxelChunkProxySection>& Section : Sections)
+        {
+            FMeshBatch Mesh;
+            Mesh.VertexFactory = &Section->VertexFactory;
+            Mesh.MaterialRenderProxy = Section->Material->GetRenderProxy();
+            Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+            Mesh.Type = PT_TriangleList;
+            Mesh.DepthPriorityGroup = SDPG_World;
+            Mesh.LODIndex = 0;
+            Mesh.CastShadow = true;
+
+            FMeshBatchElement& BatchElement = Mesh.Elements[0];
+            BatchElement.IndexBuffer = &Section->IndexBuffer;
+            BatchElement.FirstIndex = 0;
+            BatchElement.NumPrimitives = Section->IndexBuffer.Indices.Num() / 3;
+            BatchElement.MinVertexIndex = 0;
+            BatchElement.MaxVertexIndex = Section->VertexBuffers.PositionVertexBuffer.GetNumVertices() - 1;
+
+            PDI->DrawMesh(Mesh, FLT_MAX);
+        }
+    }
+
+    virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+    {
+        FPrimitiveViewRelevance Result;
+        Result.bDrawRelevance = IsShown(View);
+        Result.bShadowRelevance = IsShadowCast(View);
+        Result.bStaticRelevance = true;
+        Result.bRenderInMainPass = ShouldRenderInMainPass();
+        Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+        Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+        MaterialRelevance.SetPrimitiveViewRelevance(Result);
+        Result.bVelocityRelevance = DrawsVelocity() && Result.bOpaque && Result.bRenderInMainPass;
+        return Result;
+    }
+
+    virtual bool CanBeOccluded() const override { return !MaterialRelevance.bDisableDepthTest; }
+    virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+
+private:
+    TArray<TUniquePtr<FVoxelChunkProxySection>> Sections;
+    FMaterialRelevance MaterialRelevance;
+};
+
+// ============================================================
+// Component
+// ============================================================
+
+UVoxelChunkMeshComponent::UVoxelChunkMeshComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    BodySetup = nullptr;
+}
+
+void UVoxelChunkMeshComponent::SetSections(TMap<int32, FVoxelPackedMeshSection>&& InSections)
+{
+    Sections = MoveTemp(InSections);
+
+    UpdateBounds();
+    MarkRenderStateDirty();
+    UpdateCollision();
+}
+
+void UVoxelChunkMeshComponent::ClearAllSections()
+{
+    SetSections(TMap<int32, FVoxelPackedMeshSection>());
+}
+
+SIZE_T UVoxelChunkMeshComponent::GetPackedMemoryUsage() const
+{
+    SIZE_T Bytes = Sections.GetAllocatedSize();
+    for (const auto& Pair : Sections)
+    {
+        Bytes += Pair.Value.GetAllocatedSize();
+    }
+    return Bytes;
+}
+
+FPrimitiveSceneProxy* UVoxelChunkMeshComponent::CreateSceneProxy()
+{
+    for (const auto& Pair : Sections)
+    {
+        if (!Pair.Value.IsEmpty())
+        {
+            return new FVoxelChunkSceneProxy(this);
+        }
+    }
+    return nullptr;
+}
+
+int32 UVoxelChunkMeshComponent::GetNumMaterials() const
+{
+    int32 NumMaterials = 0;
+    for (const auto& Pair : Sections)
+    {
+        NumMaterials = FMath::Max(NumMaterials, FMath::Max(0, Pair.Key) + 1);
+    }
+    return NumMaterials;
+}
+
+FBoxSphereBounds UVoxelChunkMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    FBox3f LocalBox(ForceInit);
+    for (const auto& Pair : Sections)
+    {
+        LocalBox += Pair.Value.Bounds;
+    }
+    if (!LocalBox.IsValid)
+    {
+        return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.0);
+    }
+    return FBoxSphereBounds(FBox(LocalBox)).TransformBy(LocalToWorld);
+}
+
+// ============================================================
+// Collision
+// ============================================================
+
+UBodySetup* UVoxelChunkMeshComponent::GetBodySetup()
+{
+    if (!BodySetup)
+    {
+        BodySetup = NewObject<UBodySetup>(this, NAME_None, IsTemplate() ? RF_Public | RF_ArchetypeObject : RF_NoFlags);
+        BodySetup->BodySetupGuid = FGuid::NewGuid();
+        BodySetup->bGenerateMirroredCollision = false;
+        BodySetup->bDoubleSidedGeometry = true;
+        BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+    }
+    return BodySetup;
+}
+
+void UVoxelChunkMeshComponent::UpdateCollision()
+{
+    // Все секции кукаются одним мешем: UProceduralMeshComponent пересобирал коллизию на каждую секцию
+    UBodySetup* Setup = GetBodySetup();
+    Setup->InvalidatePhysicsData();
+    Setup->CreatePhysicsMeshes();
+    RecreatePhysicsState();
+}
+
+bool UVoxelChunkMeshComponent::GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+    for (const auto& Pair : Sections)
+    {
+        const FVoxelPackedMeshSection& Section = Pair.Value;
+        if (Section.IsEmpty()) continue;
+
+        const int32 VertexBase = CollisionData->Vertices.Num();
+        for (const FVoxelPackedVertex& Vertex : Section.Vertices)
+        {
+            CollisionData->Vertices.Add(FVoxelPackedMesh::DecodePosition(Vertex));
+        }
+
+        const uint16 MaterialIndex = (uint16)FMath::Max(0, Pair.Key);
+        for (int32 Index = 0; Index + 2 < Section.Indices.Num(); Index += 3)
+        {
+            FTriIndices& Triangle = CollisionData->Indices.AddDefaulted_GetRef();
+            Triangle.v0 = VertexBase + Section.Indices[Index];
+            Triangle.v1 = VertexBase + Section.Indices[Index + 1];
+            Triangle.v2 = VertexBase + Section.Indices[Index + 2];
+            CollisionData->MaterialIndices.Add(MaterialIndex);
+        }
+    }
+
+    CollisionData->bFlipNormals = true;
+    CollisionData->bDeformableMesh = true;
+    CollisionData->bFastCook = true;
+    return CollisionData->Indices.Num() > 0;
+}
+
+bool UVoxelChunkMeshComponent::ContainsPhysicsTriMeshData(bool InUseAllTriData) const
+{
+    for (const auto& Pair : Sections)
+    {
+        if (!Pair.Value.IsEmpty()) return true;
+    }
+    return false;
+}
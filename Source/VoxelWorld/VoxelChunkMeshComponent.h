@@ -0,0 +1,51 @@
+// VoxelChunkMeshComponent.h
+// Компонент меша чанка вместо UProceduralMeshComponent: хранит секции в упакованном формате
+// (FVoxelPackedMesh), рисует их своим scene proxy как статику и кукает коллизию один раз на чанк.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "VoxelPackedMesh.h"
+#include "VoxelChunkMeshComponent.generated.h"
+
+class UBodySetup;
+
+UCLASS()
+class VOXELWORLD_API UVoxelChunkMeshComponent : public UMeshComponent, public IInterface_CollisionDataProvider
+{
+    GENERATED_BODY()
+
+public:
+    UVoxelChunkMeshComponent();
+
+    // Заменить все секции (ключ — индекс материала): границы, proxy и коллизия пересоздаются один раз
+    void SetSections(TMap<int32, FVoxelPackedMeshSection>&& InSections);
+    void ClearAllSections();
+
+    const TMap<int32, FVoxelPackedMeshSection>& GetSections() const { return Sections; }
+    // Память упакованных секций на CPU (копии в буферах GPU не входят)
+    SIZE_T GetPackedMemoryUsage() const;
+
+    virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual UBodySetup* GetBodySetup() override;
+    virtual int32 GetNumMaterials() const override;
+
+    // Коллизия: треугольники всех секций из распакованных позиций
+    virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData) override;
+    virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override;
+    virtual bool WantsNegXTriMesh() override { return false; }
+
+private:
+    virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+    // Пересобрать коллизию синхронно: чанк готов к столкновениям в кадре применения меша
+    void UpdateCollision();
+
+    TMap<int32, FVoxelPackedMeshSection> Sections;
+
+    // Создаётся один раз; при смене меша только инвалидируется
+    UPROPERTY(Instanced)
+    UBodySetup* BodySetup;
+};
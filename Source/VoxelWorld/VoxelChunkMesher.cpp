@@ -0,0 +1,1524 @@
+// VoxelChunkMesher.cpp
+
+#include "VoxelChunkMesher.h"
+#include "VoxelDatabase.h"
+#include "VoxelDensitySmoothing.h"
+#include "VoxelHeightmapCache.h"
+#include "VoxelNoise.h"
+
+// ============================================================
+// Marching Cubes lookup tables
+// ============================================================
+
+const int32 FVoxelChunkMesher::EdgeTable[256] = {
+    0x0  , 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+    0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+    0x190, 0x99 , 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+    0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+    0x230, 0x339, 0x33 , 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+    0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+    0x3a0, 0x2a9, 0x1a3, 0xaa , 0x7a6, 0x6af, 0x5a5, 0x4ac,
+    0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+    0x460, 0x569, 0x663, 0x76a, 0x66 , 0x16f, 0x265, 0x36c,
+    0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+    0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff , 0x3f5, 0x2fc,
+    0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+    0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55 , 0x15c,
+    0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+    0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc ,
+    0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+    0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+    0xcc , 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+    0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+    0x15c, 0x55 , 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+    0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+    0x2fc, 0x3f5, 0xff , 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+    0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+    0x36c, 0x265, 0x16f, 0x66 , 0x76a, 0x663, 0x569, 0x460,
+    0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+    0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa , 0x1a3, 0x2a9, 0x3a0,
+    0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+    0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33 , 0x339, 0x230,
+    0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+    0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99 , 0x190,
+    0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+    0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0
+};
+
+const int32 FVoxelChunkMesher::TriTable[256][16] = {
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 8, 3, 9, 8, 1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3, 1, 2,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 2,10, 0, 2, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 8, 3, 2,10, 8,10, 9, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3,11, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0,11, 2, 8,11, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 9, 0, 2, 3,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1,11, 2, 1, 9,11, 9, 8,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3,10, 1,11,10, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0,10, 1, 0, 8,10, 8,11,10,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 9, 0, 3,11, 9,11,10, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 8,10,10, 8,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 3, 0, 7, 3, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 8, 4, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 1, 9, 4, 7, 1, 7, 3, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 8, 4, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 4, 7, 3, 0, 4, 1, 2,10,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 2,10, 9, 0, 2, 8, 4, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 2,10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4,-1,-1,-1,-1},
+    { 8, 4, 7, 3,11, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {11, 4, 7,11, 2, 4, 2, 0, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 0, 1, 8, 4, 7, 2, 3,11,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 7,11, 9, 4,11, 9,11, 2, 9, 2, 1,-1,-1,-1,-1},
+    { 3,10, 1, 3,11,10, 7, 8, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 1,11,10, 1, 4,11, 1, 0, 4, 7,11, 4,-1,-1,-1,-1},
+    { 4, 7, 8, 9, 0,11, 9,11,10,11, 0, 3,-1,-1,-1,-1},
+    { 4, 7,11, 4,11, 9, 9,11,10,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 5, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 5, 4, 0, 8, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 5, 4, 1, 5, 0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 5, 4, 8, 3, 5, 3, 1, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 9, 5, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,10, 4, 9, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 2,10, 5, 4, 2, 4, 0, 2,-1,-1,-1,-1,-1,-1,-1},
+    { 2,10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8,-1,-1,-1,-1},
+    { 9, 5, 4, 2, 3,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0,11, 2, 0, 8,11, 4, 9, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 5, 4, 0, 1, 5, 2, 3,11,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 5, 2, 5, 8, 2, 8,11, 4, 8, 5,-1,-1,-1,-1},
+    {10, 3,11,10, 1, 3, 9, 5, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 9, 5, 0, 8, 1, 8,10, 1, 8,11,10,-1,-1,-1,-1},
+    { 5, 4, 0, 5, 0,11, 5,11,10,11, 0, 3,-1,-1,-1,-1},
+    { 5, 4, 8, 5, 8,10,10, 8,11,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 7, 8, 5, 7, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 3, 0, 9, 5, 3, 5, 7, 3,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 7, 8, 0, 1, 7, 1, 5, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 5, 3, 3, 5, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 7, 8, 9, 5, 7,10, 1, 2,-1,-1,-1,-1,-1,-1,-1},
+    {10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3,-1,-1,-1,-1},
+    { 8, 0, 2, 8, 2, 5, 8, 5, 7,10, 5, 2,-1,-1,-1,-1},
+    { 2,10, 5, 2, 5, 3, 3, 5, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 9, 5, 7, 8, 9, 3,11, 2,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7,11,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 8, 1, 7, 8, 1, 5, 7,-1,-1,-1,-1},
+    {11, 2, 1,11, 1, 7, 7, 1, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 5, 8, 8, 5, 7,10, 1, 3,10, 3,11,-1,-1,-1,-1},
+    { 5, 7, 0, 5, 0, 9, 7,11, 0, 1, 0,10,11,10, 0,-1},
+    {11,10, 0,11, 0, 3,10, 5, 0, 8, 0, 7, 5, 7, 0,-1},
+    {11,10, 5, 7,11, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {10, 6, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3, 5,10, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 0, 1, 5,10, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 8, 3, 1, 9, 8, 5,10, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 6, 5, 2, 6, 1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 6, 5, 1, 2, 6, 3, 0, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 6, 5, 9, 0, 6, 0, 2, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8,-1,-1,-1,-1},
+    { 2, 3,11,10, 6, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {11, 0, 8,11, 2, 0,10, 6, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 2, 3,11, 5,10, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 5,10, 6, 1, 9, 2, 9,11, 2, 9, 8,11,-1,-1,-1,-1},
+    { 6, 3,11, 6, 5, 3, 5, 1, 3,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8,11, 0,11, 5, 0, 5, 1, 5,11, 6,-1,-1,-1,-1},
+    { 3,11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9,-1,-1,-1,-1},
+    { 6, 5, 9, 6, 9,11,11, 9, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 5,10, 6, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 3, 0, 4, 7, 3, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 9, 0, 5,10, 6, 8, 4, 7,-1,-1,-1,-1,-1,-1,-1},
+    {10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4,-1,-1,-1,-1},
+    { 6, 1, 2, 6, 5, 1, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7,-1,-1,-1,-1},
+    { 8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6,-1,-1,-1,-1},
+    { 7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9,-1},
+    { 3,11, 2, 7, 8, 4,10, 6, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 5,10, 6, 4, 7, 2, 4, 2, 0, 2, 7,11,-1,-1,-1,-1},
+    { 0, 1, 9, 4, 7, 8, 2, 3,11, 5,10, 6,-1,-1,-1,-1},
+    { 9, 2, 1, 9,11, 2, 9, 4,11, 7,11, 4, 5,10, 6,-1},
+    { 8, 4, 7, 3,11, 5, 3, 5, 1, 5,11, 6,-1,-1,-1,-1},
+    { 5, 1,11, 5,11, 6, 1, 0,11, 7,11, 4, 0, 4,11,-1},
+    { 0, 5, 9, 0, 6, 5, 0, 3, 6,11, 6, 3, 8, 4, 7,-1},
+    { 6, 5, 9, 6, 9,11, 4, 7, 9, 7,11, 9,-1,-1,-1,-1},
+    {10, 4, 9, 6, 4,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4,10, 6, 4, 9,10, 0, 8, 3,-1,-1,-1,-1,-1,-1,-1},
+    {10, 0, 1,10, 6, 0, 6, 4, 0,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1,10,-1,-1,-1,-1},
+    { 1, 4, 9, 1, 2, 4, 2, 6, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4,-1,-1,-1,-1},
+    { 0, 2, 4, 4, 2, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 3, 2, 8, 2, 4, 4, 2, 6,-1,-1,-1,-1,-1,-1,-1},
+    {10, 4, 9,10, 6, 4,11, 2, 3,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 2, 2, 8,11, 4, 9,10, 4,10, 6,-1,-1,-1,-1},
+    { 3,11, 2, 0, 1, 6, 0, 6, 4, 6, 1,10,-1,-1,-1,-1},
+    { 6, 4, 1, 6, 1,10, 4, 8, 1, 2, 1,11, 8,11, 1,-1},
+    { 9, 6, 4, 9, 3, 6, 9, 1, 3,11, 6, 3,-1,-1,-1,-1},
+    { 8,11, 1, 8, 1, 0,11, 6, 1, 9, 1, 4, 6, 4, 1,-1},
+    { 3,11, 6, 3, 6, 0, 0, 6, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 6, 4, 8,11, 6, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7,10, 6, 7, 8,10, 8, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 7, 3, 0,10, 7, 0, 9,10, 6, 7,10,-1,-1,-1,-1},
+    {10, 6, 7, 1,10, 7, 1, 7, 8, 1, 8, 0,-1,-1,-1,-1},
+    {10, 6, 7,10, 7, 1, 1, 7, 3,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7,-1,-1,-1,-1},
+    { 2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9,-1},
+    { 7, 8, 0, 7, 0, 6, 6, 0, 2,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 3, 2, 6, 7, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11,10, 6, 8,10, 8, 9, 8, 6, 7,-1,-1,-1,-1},
+    { 2, 0, 7, 2, 7,11, 0, 9, 7, 6, 7,10, 9,10, 7,-1},
+    { 1, 8, 0, 1, 7, 8, 1,10, 7, 6, 7,10, 2, 3,11,-1},
+    {11, 2, 1,11, 1, 7,10, 6, 1, 6, 7, 1,-1,-1,-1,-1},
+    { 8, 9, 6, 8, 6, 7, 9, 1, 6,11, 6, 3, 1, 3, 6,-1},
+    { 0, 9, 1,11, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 8, 0, 7, 0, 6, 3,11, 0,11, 6, 0,-1,-1,-1,-1},
+    { 7,11, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8,11, 7, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9,11, 7, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 1, 9, 8, 3, 1,11, 7, 6,-1,-1,-1,-1,-1,-1,-1},
+    {10, 1, 2, 6,11, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 3, 0, 8, 6,11, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 9, 0, 2,10, 9, 6,11, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 6,11, 7, 2,10, 3,10, 8, 3,10, 9, 8,-1,-1,-1,-1},
+    { 7, 2, 3, 6, 2, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 0, 8, 7, 6, 0, 6, 2, 0,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 7, 6, 2, 3, 7, 0, 1, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6,-1,-1,-1,-1},
+    {10, 7, 6,10, 1, 7, 1, 3, 7,-1,-1,-1,-1,-1,-1,-1},
+    {10, 7, 6, 1, 7,10, 1, 8, 7, 1, 0, 8,-1,-1,-1,-1},
+    { 0, 3, 7, 0, 7,10, 0,10, 9, 6,10, 7,-1,-1,-1,-1},
+    { 7, 6,10, 7,10, 8, 8,10, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 6, 8, 4,11, 8, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 6,11, 3, 0, 6, 0, 4, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 6,11, 8, 4, 6, 9, 0, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 4, 6, 9, 6, 3, 9, 3, 1,11, 3, 6,-1,-1,-1,-1},
+    { 6, 8, 4, 6,11, 8, 2,10, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 3, 0,11, 0, 6,11, 0, 4, 6,-1,-1,-1,-1},
+    { 4,11, 8, 4, 6,11, 0, 2, 9, 2,10, 9,-1,-1,-1,-1},
+    {10, 9, 3,10, 3, 2, 9, 4, 3,11, 3, 6, 4, 6, 3,-1},
+    { 8, 2, 3, 8, 4, 2, 4, 6, 2,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 4, 2, 4, 6, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8,-1,-1,-1,-1},
+    { 1, 9, 4, 1, 4, 2, 2, 4, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 1, 3, 8, 6, 1, 8, 4, 6, 6,10, 1,-1,-1,-1,-1},
+    {10, 1, 0,10, 0, 6, 6, 0, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 6, 3, 4, 3, 8, 6,10, 3, 0, 3, 9,10, 9, 3,-1},
+    {10, 9, 4, 6,10, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 9, 5, 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3, 4, 9, 5,11, 7, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 0, 1, 5, 4, 0, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    {11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5,-1,-1,-1,-1},
+    { 9, 5, 4,10, 1, 2, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 6,11, 7, 1, 2,10, 0, 8, 3, 4, 9, 5,-1,-1,-1,-1},
+    { 7, 6,11, 5, 4,10, 4, 2,10, 4, 0, 2,-1,-1,-1,-1},
+    { 3, 4, 8, 3, 5, 4, 3, 2, 5,10, 5, 2,11, 7, 6,-1},
+    { 7, 2, 3, 7, 6, 2, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7,-1,-1,-1,-1},
+    { 3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0,-1,-1,-1,-1},
+    { 6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8,-1},
+    { 9, 5, 4,10, 1, 6, 1, 7, 6, 1, 3, 7,-1,-1,-1,-1},
+    { 1, 6,10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4,-1},
+    { 4, 0,10, 4,10, 5, 0, 3,10, 6,10, 7, 3, 7,10,-1},
+    { 7, 6,10, 7,10, 8, 5, 4,10, 4, 8,10,-1,-1,-1,-1},
+    { 6, 9, 5, 6,11, 9,11, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 6,11, 0, 6, 3, 0, 5, 6, 0, 9, 5,-1,-1,-1,-1},
+    { 0,11, 8, 0, 5,11, 0, 1, 5, 5, 6,11,-1,-1,-1,-1},
+    { 6,11, 3, 6, 3, 5, 5, 3, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 9, 5,11, 9,11, 8,11, 5, 6,-1,-1,-1,-1},
+    { 0,11, 3, 0, 6,11, 0, 9, 6, 5, 6, 9, 1, 2,10,-1},
+    {11, 8, 5,11, 5, 6, 8, 0, 5,10, 5, 2, 0, 2, 5,-1},
+    { 6,11, 3, 6, 3, 5, 2,10, 3,10, 5, 3,-1,-1,-1,-1},
+    { 5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2,-1,-1,-1,-1},
+    { 9, 5, 6, 9, 6, 0, 0, 6, 2,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8,-1},
+    { 1, 5, 6, 2, 1, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 6, 1, 6,10, 3, 8, 6, 5, 6, 9, 8, 9, 6,-1},
+    {10, 1, 0,10, 0, 6, 9, 5, 0, 5, 6, 0,-1,-1,-1,-1},
+    { 0, 3, 8, 5, 6,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {10, 5, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {11, 5,10, 7, 5,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {11, 5,10,11, 7, 5, 8, 3, 0,-1,-1,-1,-1,-1,-1,-1},
+    { 5,11, 7, 5,10,11, 1, 9, 0,-1,-1,-1,-1,-1,-1,-1},
+    {10, 7, 5,10,11, 7, 9, 8, 1, 8, 3, 1,-1,-1,-1,-1},
+    {11, 1, 2,11, 7, 1, 7, 5, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2,11,-1,-1,-1,-1},
+    { 9, 7, 5, 9, 2, 7, 9, 0, 2, 2,11, 7,-1,-1,-1,-1},
+    { 7, 5, 2, 7, 2,11, 5, 9, 2, 3, 2, 8, 9, 8, 2,-1},
+    { 2, 5,10, 2, 3, 5, 3, 7, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 2, 0, 8, 5, 2, 8, 7, 5,10, 2, 5,-1,-1,-1,-1},
+    { 9, 0, 1, 5,10, 3, 5, 3, 7, 3,10, 2,-1,-1,-1,-1},
+    { 9, 8, 2, 9, 2, 1, 8, 7, 2,10, 2, 5, 7, 5, 2,-1},
+    { 1, 3, 5, 3, 7, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 7, 0, 7, 1, 1, 7, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 0, 3, 9, 3, 5, 5, 3, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 8, 7, 5, 9, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 8, 4, 5,10, 8,10,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 0, 4, 5,11, 0, 5,10,11,11, 3, 0,-1,-1,-1,-1},
+    { 0, 1, 9, 8, 4,10, 8,10,11,10, 4, 5,-1,-1,-1,-1},
+    {10,11, 4,10, 4, 5,11, 3, 4, 9, 4, 1, 3, 1, 4,-1},
+    { 2, 5, 1, 2, 8, 5, 2,11, 8, 4, 5, 8,-1,-1,-1,-1},
+    { 0, 4,11, 0,11, 3, 4, 5,11, 2,11, 1, 5, 1,11,-1},
+    { 0, 2, 5, 0, 5, 9, 2,11, 5, 4, 5, 8,11, 8, 5,-1},
+    { 9, 4, 5, 2,11, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 5,10, 3, 5, 2, 3, 4, 5, 3, 8, 4,-1,-1,-1,-1},
+    { 5,10, 2, 5, 2, 4, 4, 2, 0,-1,-1,-1,-1,-1,-1,-1},
+    { 3,10, 2, 3, 5,10, 3, 8, 5, 4, 5, 8, 0, 1, 9,-1},
+    { 5,10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2,-1,-1,-1,-1},
+    { 8, 4, 5, 8, 5, 3, 3, 5, 1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 4, 5, 1, 0, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5,-1,-1,-1,-1},
+    { 9, 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4,11, 7, 4, 9,11, 9,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 8, 3, 4, 9, 7, 9,11, 7, 9,10,11,-1,-1,-1,-1},
+    { 1,10,11, 1,11, 4, 1, 4, 0, 7, 4,11,-1,-1,-1,-1},
+    { 3, 1, 4, 3, 4, 8, 1,10, 4, 7, 4,11,10,11, 4,-1},
+    { 4,11, 7, 9,11, 4, 9, 2,11, 9, 1, 2,-1,-1,-1,-1},
+    { 9, 7, 4, 9,11, 7, 9, 1,11, 2,11, 1, 0, 8, 3,-1},
+    {11, 7, 4,11, 4, 2, 2, 4, 0,-1,-1,-1,-1,-1,-1,-1},
+    {11, 7, 4,11, 4, 2, 8, 3, 4, 3, 2, 4,-1,-1,-1,-1},
+    { 2, 9,10, 2, 7, 9, 2, 3, 7, 7, 4, 9,-1,-1,-1,-1},
+    { 9,10, 7, 9, 7, 4,10, 2, 7, 8, 7, 0, 2, 0, 7,-1},
+    { 3, 7,10, 3,10, 2, 7, 4,10, 1,10, 0, 4, 0,10,-1},
+    { 1,10, 2, 8, 7, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 9, 1, 4, 1, 7, 7, 1, 3,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1,-1,-1,-1,-1},
+    { 4, 0, 3, 7, 4, 3,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 8, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 9,10, 8,10,11, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9,11,11, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1,10, 0,10, 8, 8,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1,10,11, 3,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,11, 1,11, 9, 9,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9,11, 1, 2, 9, 2,11, 9,-1,-1,-1,-1},
+    { 0, 2,11, 8, 0,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8,10,10, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 9,10, 2, 0, 9, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8,10, 0, 1, 8, 1,10, 8,-1,-1,-1,-1},
+    { 1,10, 2,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 8, 9, 1, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 9, 1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1}
+};
+
+// Нормали граней в порядке масок GetColumnFaceMasks
+static const FVector FaceNormals[6] = {
+    FVector(0, 0, 1), FVector(0, 0, -1),
+    FVector(1, 0, 0), FVector(-1, 0, 0),
+    FVector(0, 1, 0), FVector(0, -1, 0)
+};
+
+// Граничные плоскости ячейки маленьких блоков 4x4x4 (бит = X + Y * 4 + Z * 16)
+static constexpr uint64 SmallCellPlaneX0 = 0x1111111111111111ull;
+static constexpr uint64 SmallCellPlaneX3 = 0x8888888888888888ull;
+static constexpr uint64 SmallCellPlaneY0 = 0x000F000F000F000Full;
+static constexpr uint64 SmallCellPlaneY3 = 0xF000F000F000F000ull;
+static constexpr uint64 SmallCellPlaneZ0 = 0x000000000000FFFFull;
+static constexpr uint64 SmallCellPlaneZ3 = 0xFFFF000000000000ull;
+
+// ============================================================
+// Build
+// ============================================================
+
+FVoxelMeshScratch& FVoxelMeshScratch::Get()
+{
+    // Рабочие потоки UE::Tasks живут всё время игры — буферы выделяются один раз на поток
+    thread_local FVoxelMeshScratch Scratch;
+    return Scratch;
+}
+
+uint32 FVoxelMeshScratch::BeginVertexCache(int32 NumKeys)
+{
+    // Массив только растёт: MC и Surface Nets используют разное число ключей,
+    // а записи прежних сборок отсекает номер
+    if (EdgeVertices.Num() < NumKeys || ++EdgeStamp == 0)
+    {
+        EdgeVertices.Init(FEdgeVertex{INDEX_NONE, INDEX_NONE, 0}, FMath::Max(NumKeys, EdgeVertices.Num()));
+        EdgeStamp = 1;
+    }
+    return EdgeStamp;
+}
+
+void FVoxelMeshScratch::BeginSections(TConstArrayView<FVoxelMeshCapacityHint> CapacityHints)
+{
+    // Секции остаются в карте с памятью прошлых сборок: у разных чанков одни и те же материалы
+    for (auto& Pair : Sections)
+    {
+        Pair.Value.Reset();
+    }
+    // Запас на правку, добавившую грани после прошлой сборки
+    for (const FVoxelMeshCapacityHint& Hint : CapacityHints)
+    {
+        Sections.FindOrAdd(Hint.MaterialIndex).Reserve(Hint.NumVertices + Hint.NumVertices / 8, Hint.NumIndices + Hint.NumIndices / 8);
+    }
+}
+
+FVoxelChunkMesher::FVoxelChunkMesher(const FIntPoint& InChunkCoords, const FVoxelChunkData& InData, const FVoxelChunkApron& InApron,
+                                     const FVoxelBlockTables& InTables, const FVoxelTerrainGenerator& InTerrain,
+                                     FVoxelHeightmapCache& InHeightmapCache, const FVoxelChunkMeshSettings& InSettings)
+    : ChunkCoords(InChunkCoords.X, InChunkCoords.Y)
+    , Data(InData)
+    , Apron(InApron)
+    , Tables(InTables)
+    , HeightmapCache(InHeightmapCache)
+    , Settings(InSettings)
+    , StoneRuntimeID(InTerrain.StoneID)
+    , GrassRuntimeID(InTerrain.GrassID)
+    , SandRuntimeID(InTerrain.SandID)
+    , Scratch(FVoxelMeshScratch::Get())
+{
+}
+
+void FVoxelChunkMesher::Build(FVoxelChunkMeshData& OutMesh)
+{
+    MeshStats = FVoxelMeshStats();
+    MeshStats.LODLevel = Settings.bUseSmoothTerrain ? FMath::Clamp(Settings.LODLevel, 0, FVoxelChunkMesher::MaxLODLevel) : 0;
+
+    const uint32 NumAllocationsBefore = FVoxelMeshAllocator::GetNumAllocations();
+    TMap<int32, FMeshSectionData>& Sections = Scratch.Sections;
+    Scratch.BeginSections(Settings.CapacityHints);
+
+    if (Settings.bUseSmoothTerrain)
+    {
+        GenerateSmoothMesh(Sections);
+    }
+    else
+    {
+        GenerateBlockyMesh(Sections);
+        MeshStats.NumBorderFacesCulled = CountBorderFacesCulled();
+    }
+    MeshStats.NumSectionAllocations = (int32)(FVoxelMeshAllocator::GetNumAllocations() - NumAllocationsBefore);
+
+    // Вершины уже упакованы: в чанк и на рендер уходит 12 байт на вершину вместо 68
+    for (const auto& Pair : Sections)
+    {
+        const FMeshSectionData& Section = Pair.Value;
+        MeshStats.NumVertices += Section.Vertices.Num();
+        MeshStats.NumTriangles += Section.Triangles.Num() / 3;
+        if (Section.IsEmpty()) continue;
+
+        FVoxelPackedMeshSection& Packed = OutMesh.PackedSections.Add(Pair.Key);
+        Packed.Vertices.Append(Section.Vertices);
+        Packed.Indices.Append(Section.Triangles);
+
+        // Границы — по квантованным позициям, как их распакует рендер
+        FVoxelPackedVertex MinVertex = Section.Vertices[0];
+        FVoxelPackedVertex MaxVertex = Section.Vertices[0];
+        for (const FVoxelPackedVertex& Vertex : Section.Vertices)
+        {
+            for (int32 Axis = 0; Axis < 3; Axis++)
+            {
+                MinVertex.Position[Axis] = FMath::Min(MinVertex.Position[Axis], Vertex.Position[Axis]);
+                MaxVertex.Position[Axis] = FMath::Max(MaxVertex.Position[Axis], Vertex.Position[Axis]);
+            }
+        }
+        Packed.Bounds = FBox3f(FVoxelPackedMesh::DecodePosition(MinVertex), FVoxelPackedMesh::DecodePosition(MaxVertex));
+    }
+    OutMesh.Stats = MeshStats;
+}
+
+int32 FVoxelChunkMesher::CountBorderFacesCulled() const
+{
+    constexpr int32 SX = VoxelConstants::ChunkSizeX;
+    constexpr int32 SY = VoxelConstants::ChunkSizeY;
+
+    // Без фартука каждая твёрдая ячейка крайнего столбца давала грань наружу
+    int32 Count = 0;
+    for (int32 Y = 0; Y < SY; Y++)
+    {
+        Count += FMath::CountBits(Data.GetColumnMask(SX - 1, Y) & Data.GetColumnMask(SX, Y, &Apron));
+        Count += FMath::CountBits(Data.GetColumnMask(0, Y) & Data.GetColumnMask(-1, Y, &Apron));
+    }
+    for (int32 X = 0; X < SX; X++)
+    {
+        Count += FMath::CountBits(Data.GetColumnMask(X, SY - 1) & Data.GetColumnMask(X, SY, &Apron));
+        Count += FMath::CountBits(Data.GetColumnMask(X, 0) & Data.GetColumnMask(X, -1, &Apron));
+    }
+    return Count;
+}
+
+// ============================================================
+// Blocky mesh generation (original)
+// ============================================================
+
+void FVoxelChunkMesher::AddFaceToSection(TMap<int32, FMeshSectionData>& Sections, int32 MaterialIndex,
+                                          const FVector& Position, const FVector& Normal, FColor Color, float Size)
+{
+    AddBoxFaceToSection(Sections, MaterialIndex, Position, Normal, Color, FVector(Size), Size);
+}
+
+void FVoxelChunkMesher::AddBoxFaceToSection(TMap<int32, FMeshSectionData>& Sections, int32 MaterialIndex,
+                                             const FVector& Position, const FVector& Normal, FColor Color,
+                                             const FVector& Extent, float UVTileSize)
+{
+    FMeshSectionData& Section = Sections.FindOrAdd(MaterialIndex);
+    
+    int32 VertexStart = Section.Vertices.Num();
+    const float EX = Extent.X;
+    const float EY = Extent.Y;
+    const float EZ = Extent.Z;
+    
+    // UV — проекция по осям грани в тайлах (FVoxelPackedMesh::GetFaceUV): у слитого квада
+    // текстура повторяется, а не растягивается. Оси U/V для каждой грани — как у одиночного куба.
+    checkSlow(UVTileSize == VoxelConstants::BlockSize || UVTileSize == VoxelConstants::PlayerBlockSize);
+    const bool bSmallTile = UVTileSize < VoxelConstants::BlockSize;
+    FVector Corners[4];
+    int32 Face;
+
+    if (Normal.Z > 0)
+    {
+        Corners[0] = Position + FVector(0, 0, EZ);
+        Corners[1] = Position + FVector(0, EY, EZ);
+        Corners[2] = Position + FVector(EX, EY, EZ);
+        Corners[3] = Position + FVector(EX, 0, EZ);
+        Face = 0;
+    }
+    else if (Normal.Z < 0)
+    {
+        Corners[0] = Position + FVector(0, 0, 0);
+        Corners[1] = Position + FVector(EX, 0, 0);
+        Corners[2] = Position + FVector(EX, EY, 0);
+        Corners[3] = Position + FVector(0, EY, 0);
+        Face = 1;
+    }
+    else if (Normal.X > 0)
+    {
+        Corners[0] = Position + FVector(EX, 0, 0);
+        Corners[1] = Position + FVector(EX, 0, EZ);
+        Corners[2] = Position + FVector(EX, EY, EZ);
+        Corners[3] = Position + FVector(EX, EY, 0);
+        Face = 2;
+    }
+    else if (Normal.X < 0)
+    {
+        Corners[0] = Position + FVector(0, 0, 0);
+        Corners[1] = Position + FVector(0, EY, 0);
+        Corners[2] = Position + FVector(0, EY, EZ);
+        Corners[3] = Position + FVector(0, 0, EZ);
+        Face = 3;
+    }
+    else if (Normal.Y > 0)
+    {
+        Corners[0] = Position + FVector(0, EY, 0);
+        Corners[1] = Position + FVector(EX, EY, 0);
+        Corners[2] = Position + FVector(EX, EY, EZ);
+        Corners[3] = Position + FVector(0, EY, EZ);
+        Face = 4;
+    }
+    else
+    {
+        Corners[0] = Position + FVector(0, 0, 0);
+        Corners[1] = Position + FVector(0, 0, EZ);
+        Corners[2] = Position + FVector(EX, 0, EZ);
+        Corners[3] = Position + FVector(EX, 0, 0);
+        Face = 5;
+    }
+
+    for (int32 i = 0; i < 4; i++)
+    {
+        Section.Vertices.Add(FVoxelPackedMesh::MakeFaceVertex(Corners[i], Face, bSmallTile, Color));
+    }
+
+    Section.Triangles.Add(VertexStart + 0);
+    Section.Triangles.Add(VertexStart + 1);
+    Section.Triangles.Add(VertexStart + 2);
+    Section.Triangles.Add(VertexStart + 0);
+    Section.Triangles.Add(VertexStart + 2);
+    Section.Triangles.Add(VertexStart + 3);
+}
+
+void FVoxelChunkMesher::GenerateBlockyMesh(TMap<int32, FMeshSectionData>& MeshSections)
+{
+    if (Settings.bUseGreedyMeshing)
+    {
+        GenerateGreedyBlockyFaces(MeshSections);
+    }
+    else
+    {
+        const uint32 MeshedZ = Data.GetMeshedZMask(&Apron);
+        for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X++)
+        {
+            for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y++)
+            {
+                if ((Data.ColumnSolidMasks[FVoxelChunkData::GetColumnIndex(X, Y)] & MeshedZ) == 0) continue;
+                
+                uint32 FaceMasks[6];
+                Data.GetColumnFaceMasks(X, Y, FaceMasks, &Apron);
+                
+                // Обходим только блоки хотя бы с одной видимой гранью вне пропущенных секций
+                uint32 Visible = (FaceMasks[0] | FaceMasks[1] | FaceMasks[2] | FaceMasks[3] | FaceMasks[4] | FaceMasks[5]) & MeshedZ;
+                while (Visible)
+                {
+                    const int32 Z = FMath::CountTrailingZeros(Visible);
+                    Visible &= Visible - 1;
+                    
+                    const uint16 BlockID = Data.GetBlockAtIndex(FVoxelChunkData::GetBlockIndex(X, Y, Z));
+                    const int32 MaterialIndex = Tables.GetMaterialIndex(BlockID);
+                    const FColor Color = Tables.GetColor(BlockID);
+                    FVector Position(X * VoxelConstants::BlockSize, Y * VoxelConstants::BlockSize, Z * VoxelConstants::BlockSize);
+
+                    for (int32 Face = 0; Face < 6; Face++)
+                    {
+                        if (FaceMasks[Face] & (1u << Z))
+                        {
+                            AddFaceToSection(MeshSections, MaterialIndex, Position, FaceNormals[Face], Color, VoxelConstants::BlockSize);
+                            MeshStats.NumBlockFaces++;
+                            MeshStats.NumBlockQuads++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Маленькие блоки
+    GenerateSmallBlockFaces(MeshSections);
+}
+
+void FVoxelChunkMesher::GenerateSmallBlockFaces(TMap<int32, FMeshSectionData>& MeshSections)
+{
+    const float PBS = VoxelConstants::PlayerBlockSize;
+    constexpr int32 Sub = VoxelConstants::SubBlocksPerBlock;
+    constexpr int32 SX = VoxelConstants::ChunkSizeX;
+    constexpr int32 SY = VoxelConstants::ChunkSizeY;
+    
+    Data.SmallBlocks.ForEachCell([&](int32 CellIndex, const FVoxelSmallBlockCell& Cell)
+    {
+        const int32 X = CellIndex % SX;
+        const int32 Y = (CellIndex / SX) % SY;
+        const int32 Z = CellIndex / (SX * SY);
+        
+        const uint64 Mask = Cell.Occupancy;
+        // Внутренние соседи: если ячейка ещё и занята большим блоком, закрыто всё
+        const uint64 Own = Data.GetCellOccupancy(X, Y, Z);
+        
+        // Маска соседа по направлению грани: сдвиг внутри ячейки + граничная плоскость соседней ячейки
+        uint64 Covered[6];
+        Covered[0] = ((Own >> 16) & ~SmallCellPlaneZ3) | ((Data.GetCellOccupancy(X, Y, Z + 1, &Apron) << 48) & SmallCellPlaneZ3);
+        Covered[1] = ((Own << 16) & ~SmallCellPlaneZ0) | ((Data.GetCellOccupancy(X, Y, Z - 1, &Apron) >> 48) & SmallCellPlaneZ0);
+        Covered[2] = ((Own >> 1) & ~SmallCellPlaneX3) | ((Data.GetCellOccupancy(X + 1, Y, Z, &Apron) << 3) & SmallCellPlaneX3);
+        Covered[3] = ((Own << 1) & ~SmallCellPlaneX0) | ((Data.GetCellOccupancy(X - 1, Y, Z, &Apron) >> 3) & SmallCellPlaneX0);
+        Covered[4] = ((Own >> 4) & ~SmallCellPlaneY3) | ((Data.GetCellOccupancy(X, Y + 1, Z, &Apron) << 12) & SmallCellPlaneY3);
+        Covered[5] = ((Own << 4) & ~SmallCellPlaneY0) | ((Data.GetCellOccupancy(X, Y - 1, Z, &Apron) >> 12) & SmallCellPlaneY0);
+        
+        for (int32 Face = 0; Face < 6; Face++)
+        {
+            uint64 Visible = Mask & ~Covered[Face];
+            while (Visible)
+            {
+                const int32 Bit = (int32)FMath::CountTrailingZeros64(Visible);
+                Visible &= Visible - 1;
+                
+                const uint16 SmallID = Data.SmallBlocks.GetPaletteValue(Cell.PaletteIndices[Cell.GetRank(Bit)]);
+                const FVector Position(
+                    (X * Sub + (Bit & 3)) * PBS,
+                    (Y * Sub + ((Bit >> 2) & 3)) * PBS,
+                    (Z * Sub + (Bit >> 4)) * PBS);
+                
+                AddFaceToSection(MeshSections, Tables.GetMaterialIndex(SmallID), Position, FaceNormals[Face],
+                                 Tables.GetColor(SmallID), PBS);
+            }
+        }
+    });
+}
+
+void FVoxelChunkMesher::GenerateGreedyBlockyFaces(TMap<int32, FMeshSectionData>& MeshSections)
+{
+    constexpr int32 SX = VoxelConstants::ChunkSizeX;
+    constexpr int32 SY = VoxelConstants::ChunkSizeY;
+    constexpr int32 SZ = VoxelConstants::ChunkSizeZ;
+    constexpr int32 NumColumns = SX * SY;
+    const float BS = VoxelConstants::BlockSize;
+    
+    // Пустые и закрытые секции граней не дают — обходим только диапазон Z остальных
+    const uint32 MeshedZ = Data.GetMeshedZMask(&Apron);
+    if (MeshedZ == 0) return;
+    const int32 ZBegin = FMath::CountTrailingZeros(MeshedZ);
+    const int32 ZEnd = 32 - FMath::CountLeadingZeros(MeshedZ);
+    const int32 NumZ = ZEnd - ZBegin;
+    
+    // Маски видимых граней всех столбцов: [грань][столбец], бит Z
+    uint32 FaceMasks[6][NumColumns];
+    for (int32 Y = 0; Y < SY; Y++)
+    {
+        for (int32 X = 0; X < SX; X++)
+        {
+            uint32 ColumnFaces[6];
+            Data.GetColumnFaceMasks(X, Y, ColumnFaces, &Apron);
+            for (int32 Face = 0; Face < 6; Face++)
+            {
+                // В пропущенных секциях граней нет; маска лишь гарантирует диапазон Z
+                FaceMasks[Face][FVoxelChunkData::GetColumnIndex(X, Y)] = ColumnFaces[Face] & MeshedZ;
+                MeshStats.NumBlockFaces += FMath::CountBits(ColumnFaces[Face] & MeshedZ);
+            }
+        }
+    }
+    
+    // Срез грани: двумерная сетка (U,V) ключей слияния. Грани сливаются,
+    // если совпадают материал и цвет — ключ упаковывает оба значения.
+    constexpr int32 MaxSliceCells = SX * SZ > SX * SY ? SX * SZ : SX * SY;
+    uint64 SliceKeys[MaxSliceCells];
+    bool SlicePresent[MaxSliceCells];
+    
+    auto MakeMergeKey = [this](uint16 BlockID) -> uint64
+    {
+        return ((uint64)(uint32)Tables.GetMaterialIndex(BlockID) << 32) | Tables.GetColor(BlockID).DWColor();
+    };
+    
+    // Жадно покрываем срез максимальными прямоугольниками.
+    // Emit(U, V, Width, Height, Key) получает прямоугольник в клетках среза.
+    auto MergeSlice = [&](int32 SizeU, int32 SizeV, auto&& Emit)
+    {
+        for (int32 V = 0; V < SizeV; V++)
+        {
+            for (int32 U = 0; U < SizeU; U++)
+            {
+                const int32 Start = U + V * SizeU;
+                if (!SlicePresent[Start]) continue;
+                
+                const uint64 Key = SliceKeys[Start];
+                
+                int32 Width = 1;
+                while (U + Width < SizeU &&
+                       SlicePresent[Start + Width] && SliceKeys[Start + Width] == Key)
+                {
+                    Width++;
+                }
+                
+                int32 Height = 1;
+                for (; V + Height < SizeV; Height++)
+                {
+                    const int32 RowStart = Start + Height * SizeU;
+                    bool bRowMatches = true;
+                    for (int32 K = 0; K < Width; K++)
+                    {
+                        if (!SlicePresent[RowStart + K] || SliceKeys[RowStart + K] != Key)
+                        {
+                            bRowMatches = false;
+                            break;
+                        }
+                    }
+                    if (!bRowMatches) break;
+                }
+                
+                for (int32 DV = 0; DV < Height; DV++)
+                {
+                    for (int32 DU = 0; DU < Width; DU++)
+                    {
+                        SlicePresent[Start + DU + DV * SizeU] = false;
+                    }
+                }
+                
+                Emit(U, V, Width, Height, Key);
+                MeshStats.NumBlockQuads++;
+            }
+        }
+    };
+    
+    auto EmitQuad = [&](int32 Face, const FVector& Position, const FVector& Extent, uint64 Key)
+    {
+        const int32 MaterialIndex = (int32)(Key >> 32);
+        const FColor Color((uint32)(Key & 0xFFFFFFFFu));
+        AddBoxFaceToSection(MeshSections, MaterialIndex, Position, FaceNormals[Face], Color, Extent, BS);
+    };
+    
+    // +Z / -Z: слои по Z, срез (U=X, V=Y)
+    for (int32 Face = 0; Face < 2; Face++)
+    {
+        for (int32 Z = ZBegin; Z < ZEnd; Z++)
+        {
+            if (!((MeshedZ >> Z) & 1u)) continue;
+            
+            bool bAny = false;
+            for (int32 Column = 0; Column < NumColumns; Column++)
+            {
+                const bool bPresent = (FaceMasks[Face][Column] >> Z) & 1u;
+                SlicePresent[Column] = bPresent;
+                if (bPresent)
+                {
+                    const int32 X = Column % SX;
+                    const int32 Y = Column / SX;
+                    SliceKeys[Column] = MakeMergeKey(Data.GetBlockAtIndex(FVoxelChunkData::GetBlockIndex(X, Y, Z)));
+                    bAny = true;
+                }
+            }
+            if (!bAny) continue;
+            
+            MergeSlice(SX, SY, [&](int32 U, int32 V, int32 W, int32 H, uint64 Key)
+            {
+                EmitQuad(Face, FVector(U * BS, V * BS, Z * BS), FVector(W * BS, H * BS, BS), Key);
+            });
+        }
+    }
+    
+    // +X / -X: слои по X, срез (U=Y, V=Z-ZBegin)
+    for (int32 Face = 2; Face < 4; Face++)
+    {
+        for (int32 X = 0; X < SX; X++)
+        {
+            bool bAny = false;
+            for (int32 Y = 0; Y < SY; Y++)
+            {
+                const uint32 Mask = FaceMasks[Face][FVoxelChunkData::GetColumnIndex(X, Y)];
+                for (int32 Z = ZBegin; Z < ZEnd; Z++)
+                {
+                    SlicePresent[Y + (Z - ZBegin) * SY] = (Mask >> Z) & 1u;
+                }
+                for (uint32 Bits = Mask; Bits; Bits &= Bits - 1)
+                {
+                    const int32 Z = FMath::CountTrailingZeros(Bits);
+                    SliceKeys[Y + (Z - ZBegin) * SY] = MakeMergeKey(Data.GetBlockAtIndex(FVoxelChunkData::GetBlockIndex(X, Y, Z)));
+                }
+                bAny |= (Mask != 0);
+            }
+            if (!bAny) continue;
+            
+            MergeSlice(SY, NumZ, [&](int32 U, int32 V, int32 W, int32 H, uint64 Key)
+            {
+                EmitQuad(Face, FVector(X * BS, U * BS, (V + ZBegin) * BS), FVector(BS, W * BS, H * BS), Key);
+            });
+        }
+    }
+    
+    // +Y / -Y: слои по Y, срез (U=X, V=Z-ZBegin)
+    for (int32 Face = 4; Face < 6; Face++)
+    {
+        for (int32 Y = 0; Y < SY; Y++)
+        {
+            bool bAny = false;
+            for (int32 X = 0; X < SX; X++)
+            {
+                const uint32 Mask = FaceMasks[Face][FVoxelChunkData::GetColumnIndex(X, Y)];
+                for (int32 Z = ZBegin; Z < ZEnd; Z++)
+                {
+                    SlicePresent[X + (Z - ZBegin) * SX] = (Mask >> Z) & 1u;
+                }
+                for (uint32 Bits = Mask; Bits; Bits &= Bits - 1)
+                {
+                    const int32 Z = FMath::CountTrailingZeros(Bits);
+                    SliceKeys[X + (Z - ZBegin) * SX] = MakeMergeKey(Data.GetBlockAtIndex(FVoxelChunkData::GetBlockIndex(X, Y, Z)));
+                }
+                bAny |= (Mask != 0);
+            }
+            if (!bAny) continue;
+            
+            MergeSlice(SX, NumZ, [&](int32 U, int32 V, int32 W, int32 H, uint64 Key)
+            {
+                EmitQuad(Face, FVector(U * BS, Y * BS, (V + ZBegin) * BS), FVector(W * BS, BS, H * BS), Key);
+            });
+        }
+    }
+}
+
+// ============================================================
+// Density field & Marching Cubes (smooth terrain)
+// ============================================================
+
+int32 FVoxelChunkMesher::DensityIndex(int32 X, int32 Y, int32 Z) const
+{
+    return X + Y * DensitySizeX() + Z * DensitySizeX() * DensitySizeY();
+}
+
+float FVoxelChunkMesher::GetDensity(int32 X, int32 Y, int32 Z) const
+{
+    if (X < 0 || X >= DensitySizeX() ||
+        Y < 0 || Y >= DensitySizeY() ||
+        Z < 0 || Z >= DensitySizeZ())
+    {
+        return -1.0f;
+    }
+    return Scratch.DensityField[DensityIndex(X, Y, Z)];
+}
+
+void FVoxelChunkMesher::BuildDensityField()
+{
+    const int32 SX = DensitySizeX();
+    const int32 SY = DensitySizeY();
+    const int32 SZ = DensitySizeZ();
+    const int32 P = DensityPadding;
+    
+    // Каждый элемент перезаписывается ниже — обнулять переиспользуемые буферы незачем
+    Scratch.DensityField.SetNumUninitialized(SX * SY * SZ, EAllowShrinking::No);
+    Scratch.DensityBlockIDs.SetNumUninitialized(SX * SY * SZ, EAllowShrinking::No);
+    
+    // ID блоков террейна (как в GenerateBlocksData)
+    const uint16 StoneID = StoneRuntimeID;
+    const uint16 GrassID = GrassRuntimeID;
+    const uint16 SandID = SandRuntimeID;
+    
+    // Мировые координаты начала чанка в блоках
+    const int32 ChunkWorldStartX = ChunkCoords.X * VoxelConstants::ChunkSizeX;
+    const int32 ChunkWorldStartY = ChunkCoords.Y * VoxelConstants::ChunkSizeY;
+    
+    // Шум всех столбцов поля плотности (с отступом в соседние чанки) из кэша высот
+    TArray<float, TInlineAllocator<32 * 32>> NoiseTile;
+    NoiseTile.SetNumUninitialized(SX * SY);
+    HeightmapCache.GetNoiseRegion(ChunkWorldStartX - P, ChunkWorldStartY - P, SX, SY, NoiseTile.GetData());
+    
+    // Блоки всех столбцов — один раз, дальше только чтение масок
+    GatherDensityColumns(NoiseTile.GetData());
+    
+    for (int32 DX = 0; DX < SX; DX++)
+    {
+        for (int32 DY = 0; DY < SY; DY++)
+        {
+            const uint32 SolidMask = DensitySolidMasks[DX + DY * SX];
+            const uint32 PlayerMask = DensityPlayerMasks[DX + DY * SX];
+            
+            // Непрерывная высота из шума (та же формула, что и в GenerateBlocksData)
+            const float NoiseValue = NoiseTile[DX + DY * SX];
+            float ContinuousHeight = FVoxelNoise::GetContinuousHeight(NoiseValue);
+            
+            // Определяем тип блока на этой высоте
+            int32 IntHeight = FVoxelNoise::GetSurfaceHeight(NoiseValue);
+            uint16 SurfaceBlock;
+            if (IntHeight < 6)
+                SurfaceBlock = SandID;
+            else
+                SurfaceBlock = GrassID;
+            
+            for (int32 DZ = 0; DZ < SZ; DZ++)
+            {
+                int32 Idx = DensityIndex(DX, DY, DZ);
+                
+                // Density = ContinuousHeight - Z
+                // Положительное = под поверхностью (твёрдое)
+                // Отрицательное = над поверхностью (воздух)
+                float Density = ContinuousHeight - (float)DZ;
+                
+                // Клампим чтобы не было слишком больших значений
+                Density = FMath::Clamp(Density, -2.0f, 2.0f);
+                
+                // Дно: Z=0 всегда твёрдое
+                if (DZ == 0)
+                {
+                    Density = FMath::Max(Density, 1.0f);
+                }
+                
+                // Учитываем ручные изменения блоков (SetBlock/RemoveBlock)
+                if (DZ > 0)
+                {
+                    int32 BlockZ = DZ - 1;
+                    bool bShouldBeSolid = (BlockZ < IntHeight);
+                    bool bActuallySolid = (SolidMask >> BlockZ) & 1u;
+                    
+                    // Если игрок удалил блок — принудительно делаем воздух
+                    if (bShouldBeSolid && !bActuallySolid)
+                    {
+                        Density = -2.0f;  // Агрессивное значение чтобы smoothing не заполнил дырку
+                    }
+                    // Если игрок поставил блок — принудительно делаем твёрдым
+                    // НО: только если это НЕ блок, поставленный игроком (large block)
+                    // Блоки игрока будут отрисованы как blocky отдельно
+                    else if (!bShouldBeSolid && bActuallySolid)
+                    {
+                        // FIX #2: Проверяем, является ли это блоком игрока —
+                        // по дельте правок, в том числе у загруженных соседей
+                        bool bIsPlayerBlock = (PlayerMask >> BlockZ) & 1u;
+                        
+                        if (!bIsPlayerBlock)
+                        {
+                            // Обычный блок (не от игрока) — включаем в density field
+                            Density = FMath::Max(Density, 0.5f);
+                        }
+                        // else: блок игрока — НЕ включаем в density field,
+                        // он будет отрисован как blocky ниже
+                    }
+                }
+                
+                Scratch.DensityField[Idx] = Density;
+                
+                // Определяем BlockID для цвета/материала
+                if (Density > 0.0f)
+                {
+                    if (DZ < IntHeight - 3)
+                        Scratch.DensityBlockIDs[Idx] = StoneID;
+                    else
+                        Scratch.DensityBlockIDs[Idx] = SurfaceBlock;
+                }
+                else
+                {
+                    Scratch.DensityBlockIDs[Idx] = SurfaceBlock;
+                }
+            }
+        }
+    }
+}
+
+void FVoxelChunkMesher::GatherDensityColumns(const float* NoiseTile)
+{
+    static_assert(DensityPadding == FVoxelChunkApron::PadLow && DensityPadding + 1 <= FVoxelChunkApron::PadHigh,
+                  "Density field must fit into the chunk apron");
+    
+    const int32 SX = DensitySizeX();
+    const int32 SY = DensitySizeY();
+    const int32 P = DensityPadding;
+    
+    for (int32 DY = 0; DY < SY; DY++)
+    {
+        for (int32 DX = 0; DX < SX; DX++)
+        {
+            const int32 X = DX - P;
+            const int32 Y = DY - P;
+            const int32 Index = DX + DY * SX;
+            const int32 Side = FVoxelChunkApron::GetSideAt(X, Y);
+            
+            if (Side == INDEX_NONE)
+            {
+                const int32 Column = FVoxelChunkData::GetColumnIndex(X, Y);
+                DensitySolidMasks[Index] = Data.ColumnSolidMasks[Column];
+                DensityPlayerMasks[Index] = Data.ColumnSolidMasks[Column] & Data.ColumnEditMasks[Column];
+            }
+            else if (Apron.HasSide(Side))
+            {
+                DensitySolidMasks[Index] = Apron.SolidMasks[FVoxelChunkApron::GetIndex(X, Y)];
+                DensityPlayerMasks[Index] = Apron.PlayerPlacedMasks[FVoxelChunkApron::GetIndex(X, Y)];
+            }
+            else
+            {
+                // Сосед не загружен: блоки такие, какими их сгенерирует рельеф
+                const int32 Height = FMath::Clamp(FVoxelNoise::GetSurfaceHeight(NoiseTile[Index]), 0, VoxelConstants::ChunkSizeZ);
+                DensitySolidMasks[Index] = Height >= VoxelConstants::ChunkSizeZ ? ~0u : ((1u << Height) - 1);
+                DensityPlayerMasks[Index] = 0;
+            }
+        }
+    }
+}
+
+void FVoxelChunkMesher::SmoothDensityField()
+{
+    if (Settings.SmoothingPasses <= 0) return;
+    
+    // Раздельный фильтр только по слоям у поверхности; результат совпадает с прежним
+    // полным кубом 3x3x3 (FVoxelDensitySmoothing::SmoothReference) в пределах Tolerance
+    FVoxelDensitySmoothing::Smooth(Scratch.DensityField, Scratch.SmoothingBuffers,
+                                   DensitySizeX(), DensitySizeY(), DensitySizeZ(), Settings.SmoothingPasses);
+}
+
+uint16 FVoxelChunkMesher::GetDominantBlockAt(int32 DensityX, int32 DensityY, int32 DensityZ) const
+{
+    int32 Idx = DensityIndex(
+        FMath::Clamp(DensityX, 0, DensitySizeX() - 1),
+        FMath::Clamp(DensityY, 0, DensitySizeY() - 1),
+        FMath::Clamp(DensityZ, 0, DensitySizeZ() - 1)
+    );
+    
+    if (Idx >= 0 && Idx < Scratch.DensityBlockIDs.Num() && Scratch.DensityBlockIDs[Idx] != FVoxelBlockTables::AirID)
+    {
+        return Scratch.DensityBlockIDs[Idx];
+    }
+    
+    return StoneRuntimeID;
+}
+
+float FVoxelChunkMesher::GetEdgeCrossing(float V1, float V2) const
+{
+    if (FMath::Abs(V1) < KINDA_SMALL_NUMBER) return 0.0f;
+    if (FMath::Abs(V2) < KINDA_SMALL_NUMBER) return 1.0f;
+    if (FMath::Abs(V1 - V2) < KINDA_SMALL_NUMBER) return 0.0f;
+    
+    return FMath::Clamp(-V1 / (V2 - V1), 0.0f, 1.0f);
+}
+
+FVector FVoxelChunkMesher::GetDensityGradient(int32 X, int32 Y, int32 Z) const
+{
+    return FVector(
+        GetDensity(X + 1, Y, Z) - GetDensity(X - 1, Y, Z),
+        GetDensity(X, Y + 1, Z) - GetDensity(X, Y - 1, Z),
+        GetDensity(X, Y, Z + 1) - GetDensity(X, Y, Z - 1));
+}
+
+void FVoxelChunkMesher::GenerateSmoothMesh(TMap<int32, FMeshSectionData>& MeshSections)
+{
+    // ============================================================
+    // ГИБРИДНЫЙ РЕНДЕР:
+    // - Верхний слой (SmoothSurfaceDepth блоков от поверхности) → Marching Cubes
+    // - Всё ниже → обычные кубы (blocky), чтобы игрок мог копать
+    // - Блоки поставленные игроком → всегда blocky
+    // ============================================================
+    
+    const float BS = VoxelConstants::BlockSize;
+    
+    // ============================================================
+    // Шаг 1: Для каждого столбца (X,Y) определяем высоту поверхности
+    // ============================================================
+    TArray<int32> SurfaceHeight;
+    SurfaceHeight.SetNum(VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY);
+    
+    const FVoxelHeightTilePtr HeightTile = HeightmapCache.GetTile(FIntPoint(ChunkCoords.X, ChunkCoords.Y));
+    for (int32 Index = 0; Index < SurfaceHeight.Num(); Index++)
+    {
+        SurfaceHeight[Index] = HeightTile->SurfaceHeights[Index];
+    }
+    
+    // Хелпер: является ли блок частью сглаживаемой поверхности
+    auto IsSurfaceLayer = [&](int32 X, int32 Y, int32 Z) -> bool
+    {
+        if (X < 0 || X >= VoxelConstants::ChunkSizeX ||
+            Y < 0 || Y >= VoxelConstants::ChunkSizeY)
+            return false;
+        int32 SH = SurfaceHeight[X + Y * VoxelConstants::ChunkSizeX];
+        // Сглаживаем блоки в диапазоне [SH - SmoothSurfaceDepth, SH + 1]
+        return (Z >= SH - Settings.SmoothSurfaceDepth && Z <= SH + 1);
+    };
+    
+    // ============================================================
+    // Шаг 2: Рендерим НИЖНИЕ блоки как кубы (blocky)
+    // ============================================================
+    const uint32 MeshedZ = Data.GetMeshedZMask(&Apron);
+    for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X++)
+    {
+        for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y++)
+        {
+            if ((Data.ColumnSolidMasks[FVoxelChunkData::GetColumnIndex(X, Y)] & MeshedZ) == 0) continue;
+            
+            // Видимость граней — те же битовые маски, что и в blocky-режиме:
+            // грань скрыта только если сосед — solid блок (в surface layer его покроет MC)
+            uint32 FaceMasks[6];
+            Data.GetColumnFaceMasks(X, Y, FaceMasks, &Apron);
+            
+            uint32 Visible = (FaceMasks[0] | FaceMasks[1] | FaceMasks[2] | FaceMasks[3] | FaceMasks[4] | FaceMasks[5]) & MeshedZ;
+            while (Visible)
+            {
+                const int32 Z = FMath::CountTrailingZeros(Visible);
+                Visible &= Visible - 1;
+                
+                // Пропускаем блоки в зоне сглаживания — они будут через MC
+                // Но блоки игрока всегда blocky
+                bool bPlayerBlock = Data.IsPlayerPlacedBlock(X, Y, Z);
+                if (!bPlayerBlock && IsSurfaceLayer(X, Y, Z)) continue;
+                
+                const uint16 BlockID = Data.GetBlockAtIndex(FVoxelChunkData::GetBlockIndex(X, Y, Z));
+                const int32 MaterialIndex = Tables.GetMaterialIndex(BlockID);
+                const FColor Color = Tables.GetColor(BlockID);
+                FVector Position(X * BS, Y * BS, Z * BS);
+                
+                for (int32 Face = 0; Face < 6; Face++)
+                {
+                    if (FaceMasks[Face] & (1u << Z))
+                        AddFaceToSection(MeshSections, MaterialIndex, Position, FaceNormals[Face], Color, BS);
+                }
+            }
+        }
+    }
+    
+    // ============================================================
+    // Шаг 3: Поверхностный слой — Marching Cubes или Surface Nets по одному полю плотности
+    // ============================================================
+    BuildDensityField();
+    SmoothDensityField();
+    
+    // LOD строится только через MC: на грубой сетке его вершины лежат ровно на границе чанка,
+    // куда крепятся юбки, а ячейкам Surface Nets у границы не хватает отступа поля
+    if (Settings.bUseSurfaceNets && GetLODStep() == 1)
+    {
+        GenerateSurfaceNets(MeshSections, SurfaceHeight);
+    }
+    else
+    {
+        GenerateMarchingCubes(MeshSections, SurfaceHeight);
+    }
+    
+    // ============================================================
+    // Шаг 4: Маленькие блоки — всегда blocky
+    // ============================================================
+    GenerateSmallBlockFaces(MeshSections);
+}
+
+int32 FVoxelChunkMesher::GetLODStep() const
+{
+    static_assert(VoxelConstants::ChunkSizeX % (1 << MaxLODLevel) == 0 && VoxelConstants::ChunkSizeY % (1 << MaxLODLevel) == 0 &&
+                  VoxelConstants::ChunkSizeZ % (1 << MaxLODLevel) == 0, "Chunk size must be a multiple of the coarsest LOD step");
+    return 1 << FMath::Clamp(Settings.LODLevel, 0, MaxLODLevel);
+}
+
+void FVoxelChunkMesher::GetSmoothCellRange(int32 SH, int32& OutZMin, int32& OutZMax) const
+{
+    OutZMin = FMath::Max(0, SH - Settings.SmoothSurfaceDepth - 1);
+    OutZMax = FMath::Min(VoxelConstants::ChunkSizeZ - 1, SH + 2);
+}
+
+void FVoxelChunkMesher::GenerateMarchingCubes(TMap<int32, FMeshSectionData>& MeshSections, const TArray<int32>& SurfaceHeight)
+{
+    const uint16 GrassID = GrassRuntimeID;
+    const uint16 SandID = SandRuntimeID;
+    
+    const float BS = VoxelConstants::BlockSize;
+    
+    const int32 P = DensityPadding;
+    
+    // Шаг сетки кубов в блоках: дальние чанки (LOD) берут каждый 2-й или 4-й узел поля плотности
+    const int32 Step = GetLODStep();
+    
+    static const int32 CubeVerts[8][3] = {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+    };
+    
+    static const int32 EdgeVertices[12][2] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0},
+        {4, 5}, {5, 6}, {6, 7}, {7, 4},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7}
+    };
+    
+    // Ребро куба -> младший угол (смещение X, Y, Z) и ось ребра (0 = X, 1 = Y, 2 = Z)
+    static const int32 EdgeOrigins[12][4] = {
+        {0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 0}, {0, 0, 0, 1},
+        {0, 0, 1, 0}, {1, 0, 1, 1}, {0, 1, 1, 0}, {0, 0, 1, 1},
+        {0, 0, 0, 2}, {1, 0, 0, 2}, {1, 1, 0, 2}, {0, 1, 0, 2}
+    };
+    
+    // Кэш вершин по рёбрам сетки: ребро, общее для соседних кубов, даёт одну вершину.
+    // Вершина принадлежит секции материала, в которой создана; на стыке песка и травы
+    // у каждой секции своя копия.
+    constexpr int32 EdgeGridX = VoxelConstants::ChunkSizeX + 1;
+    constexpr int32 EdgeGridY = VoxelConstants::ChunkSizeY + 1;
+    constexpr int32 EdgeGridZ = VoxelConstants::ChunkSizeZ + 1;
+    constexpr int32 NumGridEdges = 3 * EdgeGridX * EdgeGridY * EdgeGridZ;
+    const uint32 EdgeStamp = Scratch.BeginVertexCache(NumGridEdges);
+    TArray<FVoxelMeshScratch::FEdgeVertex>& EdgeVertexCache = Scratch.EdgeVertices;
+    
+    // Высота стенки юбки: не меньше разницы поверхностей соседних LOD на общей границе.
+    // В единицах упакованной позиции — нижняя вершина юбки копирует верхнюю со сдвигом по Z.
+    const int32 SkirtDepthUnits = LODSkirtDepth * FVoxelPackedMesh::PositionUnitsPerBlock;
+    const uint16 MinXY = FVoxelPackedMesh::EncodePosition(0.0);
+    const uint16 MaxX = FVoxelPackedMesh::EncodePosition(VoxelConstants::ChunkSizeX * BS);
+    const uint16 MaxY = FVoxelPackedMesh::EncodePosition(VoxelConstants::ChunkSizeY * BS);
+    
+    // Ребро треугольника на границе чанка (на ней лежат ровно: Lerp двух узлов границы) —
+    // вертикальная стенка вниз, закрывающая щель до поверхности соседа с другим шагом.
+    // Двусторонняя: щель видна с обеих сторон границы.
+    auto AddSkirt = [&](FMeshSectionData& Section, int32 IA, int32 IB)
+    {
+        const FVoxelPackedVertex A = Section.Vertices[IA];
+        const FVoxelPackedVertex B = Section.Vertices[IB];
+        const bool bOnBorder = (A.Position[0] == MinXY && B.Position[0] == MinXY) || (A.Position[0] == MaxX && B.Position[0] == MaxX) ||
+                               (A.Position[1] == MinXY && B.Position[1] == MinXY) || (A.Position[1] == MaxY && B.Position[1] == MaxY);
+        if (!bOnBorder) return;
+        
+        int32 Bottom[2];
+        const FVoxelPackedVertex Top[2] = {A, B};
+        for (int32 k = 0; k < 2; k++)
+        {
+            FVoxelPackedVertex Vertex = Top[k];
+            Vertex.Position[2] = (uint16)FMath::Max(0, Vertex.Position[2] - SkirtDepthUnits);
+            Bottom[k] = Section.Vertices.Add(Vertex);
+        }
+        
+        Section.Triangles.Append({IA, IB, Bottom[1], IA, Bottom[1], Bottom[0]});
+        Section.Triangles.Append({IA, Bottom[1], IB, IA, Bottom[0], Bottom[1]});
+        MeshStats.NumSkirtTriangles += 4;
+    };
+    
+    for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X += Step)
+    {
+        for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y += Step)
+        {
+            int32 SH = SurfaceHeight[X + Y * VoxelConstants::ChunkSizeX];
+            
+            // MC только в зоне поверхности; крупный куб покрывает зоны всех своих столбцов
+            int32 ZMin, ZMax;
+            GetSmoothCellRange(SH, ZMin, ZMax);
+            for (int32 CX = X; CX < X + Step; CX++)
+            {
+                for (int32 CY = Y; CY < Y + Step; CY++)
+                {
+                    int32 ColumnZMin, ColumnZMax;
+                    GetSmoothCellRange(SurfaceHeight[CX + CY * VoxelConstants::ChunkSizeX], ColumnZMin, ColumnZMax);
+                    ZMin = FMath::Min(ZMin, ColumnZMin);
+                    ZMax = FMath::Max(ZMax, ColumnZMax);
+                }
+            }
+            ZMin -= ZMin % Step;
+            ZMax = FMath::Min(ZMax, VoxelConstants::ChunkSizeZ - Step);
+            
+            for (int32 Z = ZMin; Z <= ZMax; Z += Step)
+            {
+                int32 DFX = X + P;
+                int32 DFY = Y + P;
+                int32 DFZ = Z;
+                
+                float CubeDensity[8];
+                for (int32 i = 0; i < 8; i++)
+                {
+                    CubeDensity[i] = GetDensity(
+                        DFX + CubeVerts[i][0] * Step,
+                        DFY + CubeVerts[i][1] * Step,
+                        DFZ + CubeVerts[i][2] * Step
+                    );
+                }
+                
+                int32 CubeIndex = 0;
+                for (int32 i = 0; i < 8; i++)
+                {
+                    if (CubeDensity[i] > 0.0f)
+                    {
+                        CubeIndex |= (1 << i);
+                    }
+                }
+                
+                if (EdgeTable[CubeIndex] == 0)
+                    continue;
+                
+                // Определяем блок для цвета/материала
+                const uint16 BlockID = (SH < 6) ? SandID : GrassID;
+                
+                const int32 MaterialIndex = Tables.GetMaterialIndex(BlockID);
+                const FColor Color = Tables.GetColor(BlockID);
+                
+                FMeshSectionData& Section = MeshSections.FindOrAdd(MaterialIndex);
+                
+                FVector CubePositions[8];
+                for (int32 i = 0; i < 8; i++)
+                {
+                    CubePositions[i] = FVector(
+                        (X + CubeVerts[i][0] * Step) * BS,
+                        (Y + CubeVerts[i][1] * Step) * BS,
+                        (Z + CubeVerts[i][2] * Step) * BS
+                    );
+                }
+                
+                // Вершина на ребре i: из кэша, если соседний куб той же секции её уже создал
+                auto GetEdgeVertex = [&](int32 Edge) -> int32
+                {
+                    const int32 Axis = EdgeOrigins[Edge][3];
+                    const int32 Key = ((Axis * EdgeGridZ + Z + EdgeOrigins[Edge][2] * Step) * EdgeGridY + Y + EdgeOrigins[Edge][1] * Step) * EdgeGridX
+                                      + X + EdgeOrigins[Edge][0] * Step;
+                    FVoxelMeshScratch::FEdgeVertex& Cached = EdgeVertexCache[Key];
+                    if (Cached.Stamp == EdgeStamp && Cached.MaterialIndex == MaterialIndex)
+                    {
+                        return Cached.VertexIndex;
+                    }
+                    
+                    const int32 V0Idx = EdgeVertices[Edge][0];
+                    const int32 V1Idx = EdgeVertices[Edge][1];
+                    const float T = GetEdgeCrossing(CubeDensity[V0Idx], CubeDensity[V1Idx]);
+                    const FVector Position = FMath::Lerp(CubePositions[V0Idx], CubePositions[V1Idx], T);
+                    
+                    // Нормаль — против градиента плотности (наружу из твёрдого), гладкая между кубами
+                    const FVector Gradient = FMath::Lerp(
+                        GetDensityGradient(DFX + CubeVerts[V0Idx][0] * Step, DFY + CubeVerts[V0Idx][1] * Step, DFZ + CubeVerts[V0Idx][2] * Step),
+                        GetDensityGradient(DFX + CubeVerts[V1Idx][0] * Step, DFY + CubeVerts[V1Idx][1] * Step, DFZ + CubeVerts[V1Idx][2] * Step),
+                        T);
+                    FVector Normal = (-Gradient).GetSafeNormal();
+                    if (Normal.IsNearlyZero())
+                    {
+                        Normal = FVector::UpVector;
+                    }
+                    
+                    Cached.Stamp = EdgeStamp;
+                    Cached.MaterialIndex = MaterialIndex;
+                    Cached.VertexIndex = Section.Vertices.Add(FVoxelPackedMesh::MakeSmoothVertex(Position, Normal, Color));
+                    return Cached.VertexIndex;
+                };
+                
+                for (int32 i = 0; TriTable[CubeIndex][i] != -1; i += 3)
+                {
+                    const int32 I0 = GetEdgeVertex(TriTable[CubeIndex][i]);
+                    const int32 I1 = GetEdgeVertex(TriTable[CubeIndex][i + 1]);
+                    const int32 I2 = GetEdgeVertex(TriTable[CubeIndex][i + 2]);
+                    
+                    // Вырожденный треугольник (пересечение в углу куба) — по упакованным позициям,
+                    // которые и уйдут на рендер
+                    const FVector3f TV0 = FVoxelPackedMesh::DecodePosition(Section.Vertices[I0]);
+                    const FVector3f TV1 = FVoxelPackedMesh::DecodePosition(Section.Vertices[I1]);
+                    const FVector3f TV2 = FVoxelPackedMesh::DecodePosition(Section.Vertices[I2]);
+                    if (FVector3f::CrossProduct(TV1 - TV0, TV2 - TV0).IsNearlyZero())
+                        continue;
+                    
+                    Section.Triangles.Add(I0);
+                    Section.Triangles.Add(I1);
+                    Section.Triangles.Add(I2);
+                    
+                    if (Settings.bLODSkirts)
+                    {
+                        AddSkirt(Section, I0, I1);
+                        AddSkirt(Section, I1, I2);
+                        AddSkirt(Section, I2, I0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void FVoxelChunkMesher::GenerateSurfaceNets(TMap<int32, FMeshSectionData>& MeshSections, const TArray<int32>& SurfaceHeight)
+{
+    // ============================================================
+    // Naive Surface Nets (дуальный мешер):
+    // - одна вершина на ячейку, которую пересекает поверхность — среднее точек пересечения её рёбер
+    // - на каждое пересечённое ребро сетки — квад из вершин четырёх ячеек вокруг ребра
+    // Вершины общие для всех квадов, треугольников примерно вдвое меньше, чем у MC,
+    // и нет тонких "осколков" в углах кубов.
+    // ============================================================
+    
+    const uint16 GrassID = GrassRuntimeID;
+    const uint16 SandID = SandRuntimeID;
+    
+    const float BS = VoxelConstants::BlockSize;
+    const int32 P = DensityPadding;
+    
+    static const int32 CubeVerts[8][3] = {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+        {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+    };
+    
+    static const int32 CubeEdges[12][2] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0},
+        {4, 5}, {5, 6}, {6, 7}, {7, 4},
+        {0, 4}, {1, 5}, {2, 6}, {3, 7}
+    };
+    
+    // Чанк отвечает за рёбра, начинающиеся в его столбцах. Квады рёбер на младшей границе
+    // опираются на ячейки соседа (X или Y = -1) — их вершины считаются из отступа поля
+    // плотности так же, как у соседа, поэтому шов совпадает.
+    constexpr int32 CellGridX = VoxelConstants::ChunkSizeX + 1;
+    constexpr int32 CellGridY = VoxelConstants::ChunkSizeY + 1;
+    constexpr int32 CellGridZ = VoxelConstants::ChunkSizeZ;
+    const uint32 CellStamp = Scratch.BeginVertexCache(CellGridX * CellGridY * CellGridZ);
+    TArray<FVoxelMeshScratch::FEdgeVertex>& CellVertexCache = Scratch.EdgeVertices;
+    
+    // Вершина ячейки с младшим углом (CX, CY, CZ) в секции материала; INDEX_NONE — ячейка вне поля
+    auto GetCellVertex = [&](const int32 Cell[3], FMeshSectionData& Section, int32 MaterialIndex, FColor Color) -> int32
+    {
+        const int32 CX = Cell[0];
+        const int32 CY = Cell[1];
+        const int32 CZ = Cell[2];
+        if (CX < -1 || CX >= VoxelConstants::ChunkSizeX ||
+            CY < -1 || CY >= VoxelConstants::ChunkSizeY ||
+            CZ < 0 || CZ >= CellGridZ)
+        {
+            return INDEX_NONE;
+        }
+        
+        FVoxelMeshScratch::FEdgeVertex& Cached = CellVertexCache[(CX + 1) + (CY + 1) * CellGridX + CZ * CellGridX * CellGridY];
+        if (Cached.Stamp == CellStamp && Cached.MaterialIndex == MaterialIndex)
+        {
+            return Cached.VertexIndex;
+        }
+        
+        const int32 DFX = CX + P;
+        const int32 DFY = CY + P;
+        const int32 DFZ = CZ;
+        
+        float CubeDensity[8];
+        for (int32 i = 0; i < 8; i++)
+        {
+            CubeDensity[i] = GetDensity(DFX + CubeVerts[i][0], DFY + CubeVerts[i][1], DFZ + CubeVerts[i][2]);
+        }
+        
+        FVector OffsetSum = FVector::ZeroVector;
+        FVector GradientSum = FVector::ZeroVector;
+        int32 NumCrossings = 0;
+        for (int32 Edge = 0; Edge < 12; Edge++)
+        {
+            const int32 V0Idx = CubeEdges[Edge][0];
+            const int32 V1Idx = CubeEdges[Edge][1];
+            if ((CubeDensity[V0Idx] > 0.0f) == (CubeDensity[V1Idx] > 0.0f)) continue;
+            
+            const float T = GetEdgeCrossing(CubeDensity[V0Idx], CubeDensity[V1Idx]);
+            OffsetSum += FMath::Lerp(
+                FVector(CubeVerts[V0Idx][0], CubeVerts[V0Idx][1], CubeVerts[V0Idx][2]),
+                FVector(CubeVerts[V1Idx][0], CubeVerts[V1Idx][1], CubeVerts[V1Idx][2]),
+                T);
+            GradientSum += FMath::Lerp(
+                GetDensityGradient(DFX + CubeVerts[V0Idx][0], DFY + CubeVerts[V0Idx][1], DFZ + CubeVerts[V0Idx][2]),
+                GetDensityGradient(DFX + CubeVerts[V1Idx][0], DFY + CubeVerts[V1Idx][1], DFZ + CubeVerts[V1Idx][2]),
+                T);
+            NumCrossings++;
+        }
+        
+        // Ячейка вокруг пересечённого ребра всегда содержит это ребро, но на всякий случай — центр
+        const FVector Offset = NumCrossings > 0 ? OffsetSum / NumCrossings : FVector(0.5f);
+        const FVector Position = (FVector(CX, CY, CZ) + Offset) * BS;
+        
+        FVector Normal = (-GradientSum).GetSafeNormal();
+        if (Normal.IsNearlyZero())
+        {
+            Normal = FVector::UpVector;
+        }
+        
+        Cached.Stamp = CellStamp;
+        Cached.MaterialIndex = MaterialIndex;
+        Cached.VertexIndex = Section.Vertices.Add(FVoxelPackedMesh::MakeSmoothVertex(Position, Normal, Color));
+        return Cached.VertexIndex;
+    };
+    
+    // Ячейки вокруг ребра по осям U, V (следующие за осью ребра): смещения 0 / -1,
+    // против часовой стрелки, если смотреть с конца оси ребра
+    static const int32 QuadCellOffsets[4][2] = {
+        {-1, -1}, {0, -1}, {0, 0}, {-1, 0}
+    };
+    
+    for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X++)
+    {
+        for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y++)
+        {
+            const int32 SH = SurfaceHeight[X + Y * VoxelConstants::ChunkSizeX];
+            
+            // Рёбра, начинающиеся в зоне поверхности (та же зона, что у MC, плюс верхний узел)
+            int32 ZMin, ZMax;
+            GetSmoothCellRange(SH, ZMin, ZMax);
+            
+            const uint16 BlockID = (SH < 6) ? SandID : GrassID;
+            const int32 MaterialIndex = Tables.GetMaterialIndex(BlockID);
+            const FColor Color = Tables.GetColor(BlockID);
+            
+            for (int32 Z = ZMin; Z <= ZMax + 1; Z++)
+            {
+                const int32 Point[3] = {X, Y, Z};
+                const float D0 = GetDensity(X + P, Y + P, Z);
+                
+                for (int32 Axis = 0; Axis < 3; Axis++)
+                {
+                    int32 Next[3] = {X + P, Y + P, Z};
+                    Next[Axis]++;
+                    const bool bSolidStart = D0 > 0.0f;
+                    if (bSolidStart == (GetDensity(Next[0], Next[1], Next[2]) > 0.0f)) continue;
+                    
+                    const int32 U = (Axis + 1) % 3;
+                    const int32 V = (Axis + 2) % 3;
+                    
+                    FMeshSectionData& Section = MeshSections.FindOrAdd(MaterialIndex);
+                    int32 Quad[4];
+                    bool bComplete = true;
+                    for (int32 Corner = 0; Corner < 4 && bComplete; Corner++)
+                    {
+                        int32 Cell[3] = {Point[0], Point[1], Point[2]};
+                        Cell[U] += QuadCellOffsets[Corner][0];
+                        Cell[V] += QuadCellOffsets[Corner][1];
+                        Quad[Corner] = GetCellVertex(Cell, Section, MaterialIndex, Color);
+                        bComplete = Quad[Corner] != INDEX_NONE;
+                    }
+                    if (!bComplete) continue;
+                    
+                    // Твёрдое в начале ребра — лицевая сторона смотрит вдоль оси: обход по часовой
+                    if (bSolidStart)
+                    {
+                        Swap(Quad[1], Quad[3]);
+                    }
+                    
+                    // Делим квад по короткой диагонали — меньше вытянутых треугольников
+                    FVector3f QuadPositions[4];
+                    for (int32 Corner = 0; Corner < 4; Corner++)
+                    {
+                        QuadPositions[Corner] = FVoxelPackedMesh::DecodePosition(Section.Vertices[Quad[Corner]]);
+                    }
+                    const float Diag02 = FVector3f::DistSquared(QuadPositions[0], QuadPositions[2]);
+                    const float Diag13 = FVector3f::DistSquared(QuadPositions[1], QuadPositions[3]);
+                    const int32 First = Diag02 <= Diag13 ? 0 : 1;
+                    
+                    Section.Triangles.Add(Quad[First]);
+                    Section.Triangles.Add(Quad[First + 1]);
+                    Section.Triangles.Add(Quad[(First + 2) % 4]);
+                    Section.Triangles.Add(Quad[First]);
+                    Section.Triangles.Add(Quad[(First + 2) % 4]);
+                    Section.Triangles.Add(Quad[(First + 3) % 4]);
+                }
+            }
+        }
+    }
+}
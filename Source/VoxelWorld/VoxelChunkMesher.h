@@ -0,0 +1,252 @@
+// VoxelChunkMesher.h
+// Построение меша чанка без UObject: работает в рабочих потоках над снимком данных
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelChunkData.h"
+#include "VoxelDensitySmoothing.h"
+#include "VoxelPackedMesh.h"
+#include "VoxelTerrainGenerator.h"
+
+struct FVoxelBlockTables;
+class FVoxelHeightmapCache;
+
+// Аллокатор массивов секций мешера: обычная куча + счётчик выделений потока (статистика перестройки)
+struct FVoxelMeshAllocator : public FDefaultAllocator
+{
+    class ForAnyElementType : public FDefaultAllocator::ForAnyElementType
+    {
+    public:
+        // Все пути роста TArray (Add, Reserve, SetNum) проходят здесь; освобождение (NewMax == 0) не считается
+        template <typename SizeType, typename... ArgTypes>
+        FORCEINLINE void ResizeAllocation(SizeType CurrentNum, SizeType NewMax, ArgTypes... Args)
+        {
+            if (NewMax > 0)
+            {
+                GetNumAllocations()++;
+            }
+            FDefaultAllocator::ForAnyElementType::ResizeAllocation(CurrentNum, NewMax, Args...);
+        }
+    };
+
+    template <typename ElementType>
+    class ForElementType : public ForAnyElementType
+    {
+    public:
+        FORCEINLINE ElementType* GetAllocation() const { return (ElementType*)ForAnyElementType::GetAllocation(); }
+    };
+
+    // Выделения и перевыделения массивов секций в текущем потоке
+    static uint32& GetNumAllocations()
+    {
+        thread_local uint32 NumAllocations = 0;
+        return NumAllocations;
+    }
+};
+
+template <>
+struct TAllocatorTraits<FVoxelMeshAllocator> : TAllocatorTraits<FDefaultAllocator>
+{
+};
+
+// Структура для хранения данных меша одной секции (материала): вершины сразу в упакованном формате
+struct FMeshSectionData
+{
+    TArray<FVoxelPackedVertex, FVoxelMeshAllocator> Vertices;
+    TArray<int32, FVoxelMeshAllocator> Triangles;
+
+    // Очистить без освобождения памяти: секция живёт в буферах потока и переиспользуется
+    void Reset()
+    {
+        Vertices.Reset();
+        Triangles.Reset();
+    }
+
+    void Reserve(int32 NumVertices, int32 NumIndices)
+    {
+        Vertices.Reserve(NumVertices);
+        Triangles.Reserve(NumIndices);
+    }
+
+    bool IsEmpty() const { return Vertices.Num() == 0; }
+
+    SIZE_T GetAllocatedSize() const
+    {
+        return Vertices.GetAllocatedSize() + Triangles.GetAllocatedSize();
+    }
+};
+
+// Статистика последнего построения меша чанка
+struct FVoxelMeshStats
+{
+    // Видимые грани больших блоков (столько квадов выдал бы мешер "грань = квад")
+    int32 NumBlockFaces = 0;
+    // Реально выданные квады для этих граней (меньше при greedy meshing)
+    int32 NumBlockQuads = 0;
+    int32 NumVertices = 0;
+    int32 NumTriangles = 0;
+    // Грани больших блоков на стыке с соседним чанком, закрытые его блоками (по фартуку)
+    int32 NumBorderFacesCulled = 0;
+    // Уровень детализации сглаженной поверхности и треугольники юбок на границах LOD
+    int32 LODLevel = 0;
+    int32 NumSkirtTriangles = 0;
+    // Выделения памяти под массивы секций за сборку (0, если хватило буферов потока)
+    int32 NumSectionAllocations = 0;
+
+    // Вершины и треугольники, которые дал бы мешер без слияния граней
+    int32 GetUnmergedVertices() const { return NumVertices + (NumBlockFaces - NumBlockQuads) * 4; }
+    int32 GetUnmergedTriangles() const { return NumTriangles + (NumBlockFaces - NumBlockQuads) * 2; }
+};
+
+// Размер секции прошлого меша чанка
+struct FVoxelMeshCapacityHint
+{
+    int32 MaterialIndex = 0;
+    int32 NumVertices = 0;
+    int32 NumIndices = 0;
+};
+
+// Настройки меша, копируются с актора чанка в момент запуска сборки
+struct FVoxelChunkMeshSettings
+{
+    bool bUseGreedyMeshing = true;
+    bool bUseSmoothTerrain = false;
+    int32 SmoothingPasses = 1;
+    int32 SmoothSurfaceDepth = 3;
+    // Поверхностный слой через Naive Surface Nets вместо Marching Cubes
+    bool bUseSurfaceNets = false;
+    // LOD сглаженной поверхности: MC по каждому 2^LODLevel-му узлу поля плотности
+    int32 LODLevel = 0;
+    // Юбки по краям чанка — сосед собран с другим LOD
+    bool bLODSkirts = false;
+    // Размеры секций прошлого меша чанка: резерв под них до сборки
+    TArray<FVoxelMeshCapacityHint, TInlineAllocator<8>> CapacityHints;
+};
+
+// Результат сборки: упакованные секции по индексу материала и статистика
+struct FVoxelChunkMeshData
+{
+    TMap<int32, FVoxelPackedMeshSection> PackedSections;
+    FVoxelMeshStats Stats;
+};
+
+// Рабочие буферы мешера: секции в рабочем формате, поле плотности, суммы фильтра сглаживания,
+// ID блоков и кэш вершин MC. Один экземпляр на поток (thread_local) — буферы переиспользуются
+// между сборками и не занимают память ни в чанке, ни между сборками в мешере.
+struct FVoxelMeshScratch
+{
+    // Секции текущей сборки. Между сборками очищаются без освобождения памяти (BeginSections);
+    // мешер копирует их в FVoxelChunkMeshData::PackedSections.
+    TMap<int32, FMeshSectionData> Sections;
+    // Очистить секции прошлой сборки и зарезервировать место по подсказкам
+    void BeginSections(TConstArrayView<FVoxelMeshCapacityHint> CapacityHints);
+
+    TArray<float> DensityField;
+    FVoxelDensitySmoothing::FBuffers SmoothingBuffers;
+    TArray<uint16> DensityBlockIDs;
+
+    // Вершина MC на ребре сетки (у Surface Nets — в ячейке); действительна, если Stamp == EdgeStamp текущей сборки
+    struct FEdgeVertex
+    {
+        int32 MaterialIndex;
+        int32 VertexIndex;
+        uint32 Stamp;
+    };
+    TArray<FEdgeVertex> EdgeVertices;
+    // Номер сборки: новая сборка "очищает" кэш рёбер инкрементом, без прохода по массиву
+    uint32 EdgeStamp = 0;
+    // Начать кэш вершин новой сборки на NumKeys ключей, вернуть её EdgeStamp
+    uint32 BeginVertexCache(int32 NumKeys);
+
+    // Буферы текущего потока
+    static FVoxelMeshScratch& Get();
+};
+
+// Мешер одного чанка. Читает только переданные данные, фартук, таблицы блоков и кэш высот —
+// не трогает акторы и UVoxelDatabase, поэтому безопасен вне игрового потока.
+class VOXELWORLD_API FVoxelChunkMesher
+{
+public:
+    FVoxelChunkMesher(const FIntPoint& InChunkCoords, const FVoxelChunkData& InData, const FVoxelChunkApron& InApron,
+                      const FVoxelBlockTables& InTables, const FVoxelTerrainGenerator& InTerrain,
+                      FVoxelHeightmapCache& InHeightmapCache, const FVoxelChunkMeshSettings& InSettings);
+
+    void Build(FVoxelChunkMeshData& OutMesh);
+
+    // Самый грубый LOD: шаг 4 блока, 4 x 4 x 8 кубов на чанк
+    static constexpr int32 MaxLODLevel = 2;
+
+private:
+    const FIntVector2 ChunkCoords;
+    const FVoxelChunkData& Data;
+    const FVoxelChunkApron& Apron;
+    const FVoxelBlockTables& Tables;
+    FVoxelHeightmapCache& HeightmapCache;
+    const FVoxelChunkMeshSettings Settings;
+    FVoxelMeshStats MeshStats;
+
+    // Runtime ID блоков террейна
+    const uint16 StoneRuntimeID;
+    const uint16 GrassRuntimeID;
+    const uint16 SandRuntimeID;
+
+    // === Blocky mesh (оригинальная система) ===
+    void GenerateBlockyMesh(TMap<int32, FMeshSectionData>& MeshSections);
+    void AddFaceToSection(TMap<int32, FMeshSectionData>& Sections, int32 MaterialIndex,
+                          const FVector& Position, const FVector& Normal, FColor Color, float Size);
+    // Грань бокса размером Extent; UV повторяются каждые UVTileSize (большой или маленький блок)
+    void AddBoxFaceToSection(TMap<int32, FMeshSectionData>& Sections, int32 MaterialIndex,
+                             const FVector& Position, const FVector& Normal, FColor Color,
+                             const FVector& Extent, float UVTileSize);
+    // Greedy meshing граней больших блоков по срезам битовых масок
+    void GenerateGreedyBlockyFaces(TMap<int32, FMeshSectionData>& MeshSections);
+    // Сколько граней на границе чанка закрыл фартук
+    int32 CountBorderFacesCulled() const;
+
+    // === Smooth mesh (Marching Cubes) ===
+
+    // Буферы потока, в котором идёт сборка
+    FVoxelMeshScratch& Scratch;
+
+    // Столбцы поля плотности (чанк + фартук), собираются один раз за сборку: свой чанк — из данных,
+    // загруженные соседи — из фартука (с правками игрока), незагруженные — по рельефу из кэша высот.
+    // Индекс совпадает с (DX + DY * DensitySizeX()) и с FVoxelChunkApron::GetIndex(DX - 1, DY - 1).
+    uint32 DensitySolidMasks[FVoxelChunkApron::SizeX * FVoxelChunkApron::SizeY];
+    uint32 DensityPlayerMasks[FVoxelChunkApron::SizeX * FVoxelChunkApron::SizeY];
+    void GatherDensityColumns(const float* NoiseTile);
+
+    static constexpr int32 DensityPadding = 1;
+    int32 DensitySizeX() const { return VoxelConstants::ChunkSizeX + 1 + DensityPadding * 2; }
+    int32 DensitySizeY() const { return VoxelConstants::ChunkSizeY + 1 + DensityPadding * 2; }
+    int32 DensitySizeZ() const { return VoxelConstants::ChunkSizeZ + 1; }
+    int32 DensityIndex(int32 X, int32 Y, int32 Z) const;
+    float GetDensity(int32 X, int32 Y, int32 Z) const;
+
+    void BuildDensityField();
+    void SmoothDensityField();
+    void GenerateSmoothMesh(TMap<int32, FMeshSectionData>& MeshSections);
+    // Ячейки поверхностного слоя столбца с высотой поверхности SH
+    void GetSmoothCellRange(int32 SH, int32& OutZMin, int32& OutZMax) const;
+    // Шаг сетки кубов в блоках для Settings.LODLevel
+    int32 GetLODStep() const;
+    // Высота юбки LOD в блоках — не меньше шага самого грубого LOD
+    static constexpr int32 LODSkirtDepth = 4;
+    // Поверхностный слой по полю плотности: треугольники в каждом кубе (MC)
+    // или вершина на ячейку и квад на пересечённое ребро (Surface Nets)
+    void GenerateMarchingCubes(TMap<int32, FMeshSectionData>& MeshSections, const TArray<int32>& SurfaceHeight);
+    void GenerateSurfaceNets(TMap<int32, FMeshSectionData>& MeshSections, const TArray<int32>& SurfaceHeight);
+
+    uint16 GetDominantBlockAt(int32 X, int32 Y, int32 Z) const;
+    // Доля ребра (0..1) от первого угла до пересечения поверхности
+    float GetEdgeCrossing(float V1, float V2) const;
+    // Градиент плотности в узле поля (центральные разности); направлен внутрь твёрдого
+    FVector GetDensityGradient(int32 X, int32 Y, int32 Z) const;
+
+    // Грани маленьких блоков (общие для blocky и smooth режимов)
+    void GenerateSmallBlockFaces(TMap<int32, FMeshSectionData>& MeshSections);
+
+    // ======== Marching Cubes таблицы ========
+    static const int32 EdgeTable[256];
+    static const int32 TriTable[256][16];
+};
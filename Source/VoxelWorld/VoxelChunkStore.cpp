@@ -0,0 +1,169 @@
+// VoxelChunkStore.cpp
+
+#include "VoxelChunkStore.h"
+
+// Порядок кучи вытеснения: наверху самый давно использованный чанк
+static const auto IsUsedEarlier = [](const TPair<uint64, FIntPoint>& A, const TPair<uint64, FIntPoint>& B)
+{
+    return A.Key < B.Key;
+};
+
+FVoxelChunkDataRef FVoxelChunkStore::Acquire(const FIntPoint& Coords, bool& bOutCreated)
+{
+    FEntry* Entry = Entries.Find(Coords);
+    bOutCreated = (Entry == nullptr);
+    if (!Entry)
+    {
+        Entry = &Entries.Add(Coords, FEntry(MakeShared<FVoxelChunkData, ESPMode::ThreadSafe>()));
+    }
+
+    Entry->bInUse = true;
+    Entry->LastUseStamp = ++UseStamp;
+    UnsavedReleased.Remove(Coords);
+    return Entry->Data;
+}
+
+void FVoxelChunkStore::Release(const FIntPoint& Coords)
+{
+    FEntry* Entry = Entries.Find(Coords);
+    if (!Entry) return;
+
+    Entry->bInUse = false;
+    Entry->LastUseStamp = ++UseStamp;
+    UpdateBytes(Coords);
+
+    EvictionHeap.HeapPush(TPair<uint64, FIntPoint>(Entry->LastUseStamp, Coords), IsUsedEarlier);
+    if (EvictionHeap.Num() > Entries.Num() * 2 + 64)
+    {
+        CompactEvictionHeap();
+    }
+
+    EvictToBudget();
+}
+
+void FVoxelChunkStore::UpdateBytes(const FIntPoint& Coords)
+{
+    FEntry* Entry = Entries.Find(Coords);
+    if (!Entry) return;
+
+    const SIZE_T Bytes = Entry->Data->GetAllocatedSize();
+    TotalBytes = TotalBytes - Entry->Bytes + Bytes;
+    Entry->Bytes = Bytes;
+}
+
+void FVoxelChunkStore::Discard(const FIntPoint& Coords)
+{
+    if (const FEntry* Entry = Entries.Find(Coords))
+    {
+        TotalBytes -= Entry->Bytes;
+        Entries.Remove(Coords);
+    }
+    UnsavedReleased.Remove(Coords);
+}
+
+void FVoxelChunkStore::SetBudgetBytes(SIZE_T InBudgetBytes)
+{
+    BudgetBytes = InBudgetBytes;
+    EvictToBudget();
+}
+
+void FVoxelChunkStore::Empty()
+{
+    Entries.Empty();
+    EvictionHeap.Empty();
+    UnsavedReleased.Empty();
+    UseStamp = 0;
+    TotalBytes = 0;
+}
+
+int32 FVoxelChunkStore::GetNumInUse() const
+{
+    int32 Count = 0;
+    for (const auto& Pair : Entries)
+    {
+        Count += Pair.Value.bInUse ? 1 : 0;
+    }
+    return Count;
+}
+
+SIZE_T FVoxelChunkStore::GetAllocatedSize() const
+{
+    SIZE_T Size = Entries.GetAllocatedSize() + EvictionHeap.GetAllocatedSize() + UnsavedReleased.GetAllocatedSize();
+    for (const auto& Pair : Entries)
+    {
+        Size += Pair.Value.bInUse ? Pair.Value.Data->GetAllocatedSize() : Pair.Value.Bytes;
+    }
+    return Size;
+}
+
+void FVoxelChunkStore::GetUnsavedReleased(TArray<TPair<FIntPoint, FVoxelChunkData*>>& OutChunks) const
+{
+    OutChunks.Reserve(OutChunks.Num() + UnsavedReleased.Num());
+    for (const FIntPoint& Coords : UnsavedReleased)
+    {
+        const FEntry& Entry = Entries.FindChecked(Coords);
+        if (Entry.Data->bNeedsSave)
+        {
+            OutChunks.Emplace(Coords, &Entry.Data.Get());
+        }
+    }
+}
+
+void FVoxelChunkStore::Trim()
+{
+    // Записанные чанки возвращаются в очередь со своим старым номером — они первые на вытеснение
+    for (auto It = UnsavedReleased.CreateIterator(); It; ++It)
+    {
+        const FEntry& Entry = Entries.FindChecked(*It);
+        if (!Entry.Data->bNeedsSave)
+        {
+            EvictionHeap.HeapPush(TPair<uint64, FIntPoint>(Entry.LastUseStamp, *It), IsUsedEarlier);
+            It.RemoveCurrent();
+        }
+    }
+    EvictToBudget();
+}
+
+void FVoxelChunkStore::EvictToBudget()
+{
+    int32 NumEvicted = 0;
+    int32 NumUnsaved = 0;
+    while (TotalBytes > BudgetBytes && EvictionHeap.Num() > 0)
+    {
+        TPair<uint64, FIntPoint> Top;
+        EvictionHeap.HeapPop(Top, IsUsedEarlier, EAllowShrinking::No);
+
+        const FEntry* Entry = Entries.Find(Top.Value);
+        if (!Entry || Entry->bInUse || Entry->LastUseStamp != Top.Key) continue;
+
+        // Правки игрока не теряются: чанк ждёт записи на диск вне очереди и остаётся в памяти сверх бюджета
+        if (Entry->Data->bNeedsSave)
+        {
+            UnsavedReleased.Add(Top.Value);
+            NumUnsaved++;
+            continue;
+        }
+        TotalBytes -= Entry->Bytes;
+        Entries.Remove(Top.Value);
+        NumEvicted++;
+    }
+
+    if (NumEvicted > 0 || NumUnsaved > 0)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("Voxel chunk store: evicted %d chunks, %d more waiting for save, %.1f KB resident"),
+               NumEvicted, NumUnsaved, TotalBytes / 1024.0);
+    }
+}
+
+void FVoxelChunkStore::CompactEvictionHeap()
+{
+    EvictionHeap.Reset();
+    for (const auto& Pair : Entries)
+    {
+        if (!Pair.Value.bInUse && !UnsavedReleased.Contains(Pair.Key))
+        {
+            EvictionHeap.Emplace(Pair.Value.LastUseStamp, Pair.Key);
+        }
+    }
+    EvictionHeap.Heapify(IsUsedEarlier);
+}
@@ -0,0 +1,92 @@
+// VoxelChunkStore.h
+// Хранилище данных чанков мира: переживает выгрузку акторов, вытесняет давно неиспользуемые (LRU)
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelChunkData.h"
+
+// Данные чанков по координатам. Загруженный актор "держит" свои данные (Acquire);
+// после Release данные остаются в памяти, пока укладываются в бюджет,
+// и повторная загрузка чанка — это поиск в таблице, а не генерация из шума.
+class VOXELWORLD_API FVoxelChunkStore
+{
+public:
+    // Данные чанка для загружаемого актора. bOutCreated = true — данных не было,
+    // возвращён пустой чанк, который нужно сгенерировать.
+    FVoxelChunkDataRef Acquire(const FIntPoint& Coords, bool& bOutCreated);
+
+    // Актор чанка выгружен — данные можно вытеснить при превышении бюджета
+    void Release(const FIntPoint& Coords);
+
+    // Данные загруженного чанка заполнены (сгенерированы или прочитаны с диска) — пересчитать
+    // их размер в бюджете. Правки учитываются при Release.
+    void UpdateBytes(const FIntPoint& Coords);
+
+    // Актор выгружен раньше, чем данные были заполнены, — забыть запись,
+    // чтобы следующий Acquire снова вернул bOutCreated = true
+    void Discard(const FIntPoint& Coords);
+
+    // Бюджет памяти на данные невостребованных и загруженных чанков (в байтах)
+    void SetBudgetBytes(SIZE_T InBudgetBytes);
+    SIZE_T GetBudgetBytes() const { return BudgetBytes; }
+
+    void Empty();
+
+    int32 Num() const { return Entries.Num(); }
+    int32 GetNumInUse() const;
+    SIZE_T GetAllocatedSize() const;
+
+    // Обход всех чанков хранилища (например, для сохранения мира)
+    template<typename FuncType>
+    void ForEach(FuncType&& Func) const
+    {
+        for (const auto& Pair : Entries)
+        {
+            Func(Pair.Key, Pair.Value.Data);
+        }
+    }
+
+    // Невостребованные чанки с несохранёнными правками, которые вытеснение отложило.
+    // Запись на диск идёт пачкой (AVoxelWorldManager::SaveEvictedChunks), после неё вызывается Trim.
+    void GetUnsavedReleased(TArray<TPair<FIntPoint, FVoxelChunkData*>>& OutChunks) const;
+    int32 GetNumUnsavedReleased() const { return UnsavedReleased.Num(); }
+
+    // Данные не укладываются в бюджет
+    bool IsOverBudget() const { return TotalBytes > BudgetBytes; }
+
+    // Записанные чанки из GetUnsavedReleased снова становятся кандидатами; вытеснить их,
+    // если бюджет превышен. Не записанные остаются вне очереди до следующей записи.
+    void Trim();
+
+private:
+    struct FEntry
+    {
+        FVoxelChunkDataRef Data;
+        // Номер последнего Acquire/Release — чем меньше, тем дольше не использовался
+        uint64 LastUseStamp = 0;
+        // Размер данных на момент последнего Release или UpdateBytes (пока чанк загружен, он меняется)
+        SIZE_T Bytes = 0;
+        bool bInUse = false;
+
+        explicit FEntry(const FVoxelChunkDataRef& InData) : Data(InData) {}
+    };
+
+    TMap<FIntPoint, FEntry> Entries;
+    uint64 UseStamp = 0;
+    SIZE_T BudgetBytes = 64 * 1024 * 1024;
+    // Сумма FEntry::Bytes — бюджет проверяется без обхода всех чанков
+    SIZE_T TotalBytes = 0;
+
+    // Очередь вытеснения: min-куча (LastUseStamp, координаты), запись добавляется при Release.
+    // Acquire её не трогает — устаревшие записи (чанк снова загружен, отпущен позже или удалён)
+    // отбрасываются при извлечении.
+    TArray<TPair<uint64, FIntPoint>> EvictionHeap;
+    // Чанки с правками, извлечённые из очереди: ждут записи и не перебираются при каждом Release
+    TSet<FIntPoint> UnsavedReleased;
+
+    // Вытеснять невостребованные чанки с наименьшим LastUseStamp, пока сумма не уложится в бюджет
+    void EvictToBudget();
+    // Пересобрать кучу без устаревших записей, когда их стало больше, чем чанков
+    void CompactEvictionHeap();
+};
@@ -114,7 +114,10 @@ void UVoxelDatabase::CreateDefaultBlocks()
     // 4 = Decorative (Wool)
     // 5 = Special (Glass, Glowstone)
     
-    auto CreateBlock = [this](FName ID, const FString& Name, FColor Color, EBlockCategory Cat, int32 MatIndex, bool bLarge = true, bool bTransparent = false)
+    // Все свойства задаются до RegisterBlock: он копирует блок в неизменяемый снимок FVoxelBlockTables,
+    // и поздние правки UObject в таблицы не попадут
+    auto CreateBlock = [this](FName ID, const FString& Name, FColor Color, EBlockCategory Cat, int32 MatIndex, bool bLarge = true, bool bTransparent = false,
+                              int32 LightLevel = 0)
     {
         UVoxelBlockData* Block = NewObject<UVoxelBlockData>(this);
         Block->BlockID = ID;
@@ -125,6 +128,8 @@ void UVoxelDatabase::CreateDefaultBlocks()
         Block->bIsLargeBlock = bLarge;
         Block->bIsTransparent = bTransparent;
         Block->Hardness = 1.0f;
+        Block->bEmitsLight = LightLevel > 0;
+        Block->LightLevel = LightLevel;
         RegisterBlock(Block);
         return Block;
     };
@@ -155,12 +160,8 @@ void UVoxelDatabase::CreateDefaultBlocks()
     CreateBlock("Wool_Green", "Green Wool", FColor(50, 200, 50), EBlockCategory::Decorative, 4);
     
     // Специальные блоки - MaterialIndex 5
-    auto Glass = CreateBlock("Glass", "Glass", FColor(200, 220, 255), EBlockCategory::Special, 5, true, true);
-    Glass->bIsTransparent = true;
-    
-    auto Glowstone = CreateBlock("Glowstone", "Glowstone", FColor(255, 230, 150), EBlockCategory::Special, 5);
-    Glowstone->bEmitsLight = true;
-    Glowstone->LightLevel = 15;
+    CreateBlock("Glass", "Glass", FColor(200, 220, 255), EBlockCategory::Special, 5, true, true);
+    CreateBlock("Glowstone", "Glowstone", FColor(255, 230, 150), EBlockCategory::Special, 5, true, false, 15);
     
     // Маленькие версии блоков (используют те же индексы материалов)
     CreateBlock("Stone_Small", "Stone (Small)", FColor(128, 128, 128), EBlockCategory::Natural, 0, false);
@@ -207,6 +208,22 @@ void UVoxelDatabase::RegisterBlock(UVoxelBlockData* BlockData)
     BlockRegistry.Add(BlockData->BlockID, BlockData);
     BlocksByIndex.Add(BlockData);
     
+    // Публикуем новый снимок таблиц с этим блоком
+    TSharedRef<FVoxelBlockTables, ESPMode::ThreadSafe> NewTables = MakeShared<FVoxelBlockTables, ESPMode::ThreadSafe>(*BlockTables);
+    const int32 MaterialIndex = FMath::Max(0, BlockData->MaterialIndex);
+    const uint8 LightLevel = BlockData->bEmitsLight ? (uint8)FMath::Clamp(BlockData->LightLevel, 0, 15) : 0;
+    
+    if (const uint16* ExistingID = RuntimeIDs.Find(BlockData->BlockID))
+    {
+        NewTables->SetRow(*ExistingID, BlockData->BlockColor, MaterialIndex, true, BlockData->bIsTransparent, LightLevel);
+    }
+    else
+    {
+        const uint16 NewID = NewTables->AddRow(BlockData->BlockID, BlockData->BlockColor, MaterialIndex, true, BlockData->bIsTransparent, LightLevel);
+        RuntimeIDs.Add(BlockData->BlockID, NewID);
+    }
+    BlockTables = NewTables;
+    
     UE_LOG(LogTemp, Verbose, TEXT("Registered block: %s"), *BlockData->BlockID.ToString());
 }
 
@@ -219,6 +236,73 @@ void UVoxelDatabase::RegisterItem(UVoxelItemData* ItemData)
     UE_LOG(LogTemp, Verbose, TEXT("Registered item: %s"), *ItemData->ItemID.ToString());
 }
 
+// === RUNTIME ID ===
+
+uint16 FVoxelBlockTables::AddRow(FName BlockID, FColor Color, int32 MaterialIndex, bool bSolid, bool bTransparent, uint8 LightLevel)
+{
+    // MAX_uint16 не выдаётся: это метка "нет блока" при перекодировании палитр сохранений
+    checkf(BlockIDs.Num() < MAX_uint16, TEXT("Too many voxel block types (%d)"), BlockIDs.Num());
+    
+    const uint16 NewID = (uint16)BlockIDs.Add(BlockID);
+    Colors.Add(Color);
+    MaterialIndices.Add(MaterialIndex);
+    Solid.Add(bSolid);
+    Transparent.Add(bTransparent);
+    LightLevels.Add(LightLevel);
+    return NewID;
+}
+
+void FVoxelBlockTables::SetRow(uint16 ID, FColor Color, int32 MaterialIndex, bool bSolid, bool bTransparent, uint8 LightLevel)
+{
+    Colors[ID] = Color;
+    MaterialIndices[ID] = MaterialIndex;
+    Solid[ID] = bSolid;
+    Transparent[ID] = bTransparent;
+    LightLevels[ID] = LightLevel;
+}
+
+FVoxelBlockTables UVoxelDatabase::MakeAirTables()
+{
+    FVoxelBlockTables Tables;
+    Tables.AddRow(NAME_None, FColor::White, 0, false, true, 0);
+    return Tables;
+}
+
+uint16 UVoxelDatabase::GetRuntimeID(FName BlockID) const
+{
+    if (BlockID.IsNone()) return FVoxelBlockTables::AirID;
+    
+    if (const uint16* Found = RuntimeIDs.Find(BlockID))
+    {
+        return *Found;
+    }
+    return FVoxelBlockTables::AirID;
+}
+
+uint16 UVoxelDatabase::GetOrAddRuntimeID(FName BlockID)
+{
+    if (BlockID.IsNone()) return FVoxelBlockTables::AirID;
+    
+    if (const uint16* Found = RuntimeIDs.Find(BlockID))
+    {
+        return *Found;
+    }
+    
+    // Неизвестный блок: твёрдый, белый, дефолтная секция материала
+    TSharedRef<FVoxelBlockTables, ESPMode::ThreadSafe> NewTables = MakeShared<FVoxelBlockTables, ESPMode::ThreadSafe>(*BlockTables);
+    const uint16 NewID = NewTables->AddRow(BlockID, FColor::White, 0, true, false, 0);
+    BlockTables = NewTables;
+    RuntimeIDs.Add(BlockID, NewID);
+    
+    UE_LOG(LogTemp, Warning, TEXT("Unregistered block %s got runtime ID %d"), *BlockID.ToString(), NewID);
+    return NewID;
+}
+
+FName UVoxelDatabase::GetBlockIDByRuntimeID(uint16 RuntimeID) const
+{
+    return BlockTables->IsValidID(RuntimeID) ? BlockTables->GetBlockID(RuntimeID) : NAME_None;
+}
+
 UVoxelBlockData* UVoxelDatabase::GetBlockData(FName BlockID) const
 {
     if (const UVoxelBlockData* const* Found = BlockRegistry.Find(BlockID))
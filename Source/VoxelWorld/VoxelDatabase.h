@@ -62,6 +62,38 @@ struct FVoxelItemTableRow : public FTableRowBase
     FName LinkedBlockID; // Ссылка на блок по ID
 };
 
+// Плоские таблицы свойств блоков (структура массивов), индексируемые runtime ID.
+// Runtime ID назначается в RegisterBlock, 0 всегда зарезервирован под воздух.
+// Снимок неизменяем: регистрация публикует новую копию, так что хот-лупы
+// меширования и генерации читают таблицы без поиска в TMap и без блокировок.
+struct FVoxelBlockTables
+{
+    static constexpr uint16 AirID = 0;
+    
+    TArray<FName> BlockIDs;
+    TArray<FColor> Colors;
+    TArray<int32> MaterialIndices;
+    TArray<bool> Solid;
+    TArray<bool> Transparent;
+    TArray<uint8> LightLevels;
+    
+    int32 Num() const { return BlockIDs.Num(); }
+    bool IsValidID(uint16 ID) const { return ID < BlockIDs.Num(); }
+    
+    FORCEINLINE FName GetBlockID(uint16 ID) const { return BlockIDs[ID]; }
+    FORCEINLINE FColor GetColor(uint16 ID) const { return Colors[ID]; }
+    FORCEINLINE int32 GetMaterialIndex(uint16 ID) const { return MaterialIndices[ID]; }
+    FORCEINLINE bool IsSolid(uint16 ID) const { return Solid[ID]; }
+    FORCEINLINE bool IsTransparent(uint16 ID) const { return Transparent[ID]; }
+    FORCEINLINE uint8 GetLightLevel(uint16 ID) const { return LightLevels[ID]; }
+    
+    // Добавить строку таблицы, возвращает новый runtime ID
+    uint16 AddRow(FName BlockID, FColor Color, int32 MaterialIndex, bool bSolid, bool bTransparent, uint8 LightLevel);
+    void SetRow(uint16 ID, FColor Color, int32 MaterialIndex, bool bSolid, bool bTransparent, uint8 LightLevel);
+};
+
+typedef TSharedRef<const FVoxelBlockTables, ESPMode::ThreadSafe> FVoxelBlockTablesRef;
+
 UCLASS(Blueprintable, BlueprintType)
 class VOXELWORLD_API UVoxelDatabase : public UObject
 {
@@ -98,6 +130,22 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Voxel Database|Blocks")
     FColor GetBlockColor(FName BlockID) const;
     
+    // === RUNTIME ID ===
+    
+    // Runtime ID блока (0 для воздуха и незарегистрированных имён)
+    uint16 GetRuntimeID(FName BlockID) const;
+    
+    // Runtime ID блока; незарегистрированное имя получает ID со свойствами по умолчанию.
+    // Только для game thread.
+    uint16 GetOrAddRuntimeID(FName BlockID);
+    
+    FName GetBlockIDByRuntimeID(uint16 RuntimeID) const;
+    
+    // Таблицы свойств для хот-лупов. Ссылка действительна до следующей регистрации;
+    // для долгой работы (или другого потока) держите снимок из GetBlockTablesSnapshot().
+    const FVoxelBlockTables& GetBlockTables() const { return *BlockTables; }
+    FVoxelBlockTablesRef GetBlockTablesSnapshot() const { return BlockTables; }
+    
     // === МАТЕРИАЛЫ ===
     
     // Получить материал блока по ID
@@ -176,5 +224,11 @@ private:
     UPROPERTY()
     TMap<int32, UMaterialInterface*> MaterialRegistry;
     
+    // FName -> runtime ID и таблицы свойств по runtime ID
+    TMap<FName, uint16> RuntimeIDs;
+    FVoxelBlockTablesRef BlockTables = MakeShared<const FVoxelBlockTables, ESPMode::ThreadSafe>(MakeAirTables());
+    
+    static FVoxelBlockTables MakeAirTables();
+    
     bool bIsInitialized = false;
 };
@@ -0,0 +1,333 @@
+// VoxelDensitySmoothing.cpp
+
+#include "VoxelDensitySmoothing.h"
+#include "VoxelChunkData.h"
+#include "VoxelNoise.h"
+#include "Math/VectorRegister.h"
+
+// ============================================================
+// Эталон: куб 3x3x3 с проверкой границ на каждую выборку
+// ============================================================
+
+void FVoxelDensitySmoothing::SmoothReference(TArray<float>& Field, TArray<float>& Temp, int32 SizeX, int32 SizeY, int32 SizeZ, int32 Passes)
+{
+    const int32 PlaneSize = SizeX * SizeY;
+    Temp.SetNumUninitialized(PlaneSize * SizeZ, EAllowShrinking::No);
+
+    for (int32 Pass = 0; Pass < Passes; Pass++)
+    {
+        for (int32 X = 0; X < SizeX; X++)
+        {
+            for (int32 Y = 0; Y < SizeY; Y++)
+            {
+                for (int32 Z = 0; Z < SizeZ; Z++)
+                {
+                    const int32 Idx = X + Y * SizeX + Z * PlaneSize;
+
+                    // Не сглаживаем дно
+                    if (Z <= 1)
+                    {
+                        Temp[Idx] = Field[Idx];
+                        continue;
+                    }
+
+                    // Не сглаживаем точки далеко от поверхности
+                    const float CurDensity = Field[Idx];
+                    if (FMath::Abs(CurDensity) > BandLimit)
+                    {
+                        Temp[Idx] = CurDensity;
+                        continue;
+                    }
+
+                    float Sum = 0.0f;
+                    float Weight = 0.0f;
+
+                    for (int32 NDX = -1; NDX <= 1; NDX++)
+                    {
+                        for (int32 NDY = -1; NDY <= 1; NDY++)
+                        {
+                            for (int32 NDZ = -1; NDZ <= 1; NDZ++)
+                            {
+                                const int32 NX = X + NDX;
+                                const int32 NY = Y + NDY;
+                                const int32 NZ = Z + NDZ;
+
+                                // Центральная точка имеет больший вес
+                                const float W = (NDX == 0 && NDY == 0 && NDZ == 0) ? 4.0f : 1.0f;
+
+                                if (NX >= 0 && NX < SizeX &&
+                                    NY >= 0 && NY < SizeY &&
+                                    NZ >= 0 && NZ < SizeZ)
+                                {
+                                    Sum += Field[NX + NY * SizeX + NZ * PlaneSize] * W;
+                                }
+                                else
+                                {
+                                    Sum += -1.0f * W;
+                                }
+                                Weight += W;
+                            }
+                        }
+                    }
+
+                    Temp[Idx] = Sum / Weight;
+                }
+            }
+        }
+
+        // Каждый проход пишет все точки — достаточно поменять буферы местами
+        Swap(Field, Temp);
+    }
+}
+
+// ============================================================
+// Раздельный узкополосный фильтр
+// ============================================================
+//
+// Сумма куба 3x3x3 = сумма по Z трёх сумм 3x3 по XY, каждая из которых — сумма по Y трёх
+// сумм по X. Центр с весом 4 = куб + 3 * центр, вес всегда 30 (за границей — тоже выборка -1).
+// Вместо 27 выборок с проверками — 2 + 2 + 2 сложения на точку, границы обрабатываются
+// только на крайних строках и слоях. Считаются лишь слои Z с точками у поверхности
+// (и по одному слою над и под ними) — у рельефа это несколько слоёв из 33.
+
+void FVoxelDensitySmoothing::Smooth(TArray<float>& Field, FBuffers& Buffers, int32 SizeX, int32 SizeY, int32 SizeZ, int32 Passes)
+{
+    check(Field.Num() == SizeX * SizeY * SizeZ);
+
+    for (int32 Pass = 0; Pass < Passes; Pass++)
+    {
+        SmoothPass(Field, Buffers, SizeX, SizeY, SizeZ);
+    }
+}
+
+void FVoxelDensitySmoothing::SmoothPass(TArray<float>& Field, FBuffers& Buffers, int32 SizeX, int32 SizeY, int32 SizeZ)
+{
+    const int32 PlaneSize = SizeX * SizeY;
+    float* RESTRICT FieldData = Field.GetData();
+
+    // Слои Z с точками у поверхности; дно (Z <= 1) не сглаживается
+    int32 BandMinZ = INDEX_NONE;
+    int32 BandMaxZ = INDEX_NONE;
+    for (int32 Z = 2; Z < SizeZ; Z++)
+    {
+        const float* Slab = FieldData + Z * PlaneSize;
+        bool bHasBand = false;
+        for (int32 Index = 0; Index < PlaneSize; Index++)
+        {
+            bHasBand |= FMath::Abs(Slab[Index]) <= BandLimit;
+        }
+        if (bHasBand)
+        {
+            if (BandMinZ == INDEX_NONE) BandMinZ = Z;
+            BandMaxZ = Z;
+        }
+    }
+    if (BandMinZ == INDEX_NONE) return;
+
+    // Суммы 3x3 нужны для слоёв [BandMinZ - 1, BandMaxZ + 1]; слой за верхом поля не хранится
+    const int32 PlaneMinZ = BandMinZ - 1;
+    const int32 PlaneMaxZ = FMath::Min(BandMaxZ + 1, SizeZ - 1);
+
+    Buffers.RowSums.SetNumUninitialized(PlaneSize, EAllowShrinking::No);
+    Buffers.PlaneSums.SetNumUninitialized(PlaneSize * (PlaneMaxZ - PlaneMinZ + 1), EAllowShrinking::No);
+    float* RESTRICT RowSums = Buffers.RowSums.GetData();
+
+    for (int32 Z = PlaneMinZ; Z <= PlaneMaxZ; Z++)
+    {
+        const float* Slab = FieldData + Z * PlaneSize;
+        float* RESTRICT Plane = Buffers.PlaneSums.GetData() + (Z - PlaneMinZ) * PlaneSize;
+
+        // Суммы по X вдоль строк; за краем строки — -1
+        for (int32 Y = 0; Y < SizeY; Y++)
+        {
+            const float* Row = Slab + Y * SizeX;
+            float* RESTRICT OutRow = RowSums + Y * SizeX;
+
+            OutRow[0] = -1.0f + Row[0] + Row[1];
+            int32 X = 1;
+            for (; X + 4 <= SizeX - 1; X += 4)
+            {
+                const VectorRegister4Float Left = VectorLoad(Row + X - 1);
+                const VectorRegister4Float Center = VectorLoad(Row + X);
+                const VectorRegister4Float Right = VectorLoad(Row + X + 1);
+                VectorStore(VectorAdd(VectorAdd(Left, Center), Right), OutRow + X);
+            }
+            for (; X < SizeX - 1; X++)
+            {
+                OutRow[X] = Row[X - 1] + Row[X] + Row[X + 1];
+            }
+            OutRow[SizeX - 1] = Row[SizeX - 2] + Row[SizeX - 1] + -1.0f;
+        }
+
+        // Суммы по Y: внутренние строки — один непрерывный отрезок, за краем — строка из -1
+        for (int32 X = 0; X < SizeX; X++)
+        {
+            Plane[X] = -3.0f + RowSums[X] + RowSums[X + SizeX];
+        }
+        int32 Index = SizeX;
+        const int32 InnerEnd = PlaneSize - SizeX;
+        for (; Index + 4 <= InnerEnd; Index += 4)
+        {
+            const VectorRegister4Float Prev = VectorLoad(RowSums + Index - SizeX);
+            const VectorRegister4Float Cur = VectorLoad(RowSums + Index);
+            const VectorRegister4Float Next = VectorLoad(RowSums + Index + SizeX);
+            VectorStore(VectorAdd(VectorAdd(Prev, Cur), Next), Plane + Index);
+        }
+        for (; Index < InnerEnd; Index++)
+        {
+            Plane[Index] = RowSums[Index - SizeX] + RowSums[Index] + RowSums[Index + SizeX];
+        }
+        for (int32 X = InnerEnd; X < PlaneSize; X++)
+        {
+            Plane[X] = RowSums[X - SizeX] + RowSums[X] + -3.0f;
+        }
+    }
+
+    // Сумма по Z и запись на место: все суммы 3x3 посчитаны до записи, поэтому проход
+    // читает поле предыдущего прохода, как эталон с отдельным буфером
+    const VectorRegister4Float Three = VectorSetFloat1(3.0f);
+    const VectorRegister4Float Weight = VectorSetFloat1(30.0f);
+    const VectorRegister4Float Band = VectorSetFloat1(BandLimit);
+    const VectorRegister4Float OutsidePlane = VectorSetFloat1(-9.0f);
+
+    for (int32 Z = BandMinZ; Z <= BandMaxZ; Z++)
+    {
+        float* RESTRICT Slab = FieldData + Z * PlaneSize;
+        const float* Below = Buffers.PlaneSums.GetData() + (Z - 1 - PlaneMinZ) * PlaneSize;
+        const float* Mid = Below + PlaneSize;
+        const float* Above = (Z + 1 < SizeZ) ? Mid + PlaneSize : nullptr;
+
+        int32 Index = 0;
+        for (; Index + 4 <= PlaneSize; Index += 4)
+        {
+            const VectorRegister4Float Density = VectorLoad(Slab + Index);
+            const VectorRegister4Float AboveSum = Above ? VectorLoad(Above + Index) : OutsidePlane;
+            const VectorRegister4Float Sum = VectorAdd(VectorAdd(VectorAdd(VectorLoad(Below + Index), VectorLoad(Mid + Index)), AboveSum),
+                                                       VectorMultiply(Density, Three));
+            const VectorRegister4Float InBand = VectorCompareLE(VectorAbs(Density), Band);
+            VectorStore(VectorSelect(InBand, VectorDivide(Sum, Weight), Density), Slab + Index);
+        }
+        for (; Index < PlaneSize; Index++)
+        {
+            const float Density = Slab[Index];
+            if (FMath::Abs(Density) > BandLimit) continue;
+            const float AboveSum = Above ? Above[Index] : -9.0f;
+            Slab[Index] = (Below[Index] + Mid[Index] + AboveSum + Density * 3.0f) / 30.0f;
+        }
+    }
+}
+
+// ============================================================
+// Проверка и бенчмарк
+// ============================================================
+
+void FVoxelDensitySmoothing::MakeTestField(int32 FieldIndex, TArray<float>& OutField, int32 SizeX, int32 SizeY, int32 SizeZ)
+{
+    const int32 PlaneSize = SizeX * SizeY;
+    OutField.SetNumUninitialized(PlaneSize * SizeZ, EAllowShrinking::No);
+
+    // Столбцы чанка с отступом 1, как у поля плотности мешера
+    TArray<float, TInlineAllocator<32 * 32>> NoiseTile;
+    NoiseTile.SetNumUninitialized(PlaneSize);
+    FVoxelNoise::ComputeTile((FieldIndex % 64) * VoxelConstants::ChunkSizeX - 1,
+                             (FieldIndex / 64) * VoxelConstants::ChunkSizeY - 1,
+                             SizeX, SizeY, NoiseTile.GetData());
+
+    for (int32 Column = 0; Column < PlaneSize; Column++)
+    {
+        const float ContinuousHeight = FVoxelNoise::GetContinuousHeight(NoiseTile[Column]);
+        const int32 IntHeight = FVoxelNoise::GetSurfaceHeight(NoiseTile[Column]);
+        for (int32 Z = 0; Z < SizeZ; Z++)
+        {
+            float Density = FMath::Clamp(ContinuousHeight - (float)Z, -2.0f, 2.0f);
+            if (Z == 0)
+            {
+                Density = FMath::Max(Density, 1.0f);
+            }
+            // Редкие "выкопанные" блоки под поверхностью, как правки игрока
+            else if (Z == IntHeight && (Column * 7 + FieldIndex) % 13 == 0)
+            {
+                Density = -2.0f;
+            }
+            OutField[Column + Z * PlaneSize] = Density;
+        }
+    }
+}
+
+float FVoxelDensitySmoothing::MeasureError(int32 NumFields, int32 Passes)
+{
+    const int32 SizeX = VoxelConstants::ChunkSizeX + 3;
+    const int32 SizeY = VoxelConstants::ChunkSizeY + 3;
+    const int32 SizeZ = VoxelConstants::ChunkSizeZ + 1;
+
+    TArray<float> Reference;
+    TArray<float> Temp;
+    TArray<float> Separable;
+    FBuffers Buffers;
+
+    float MaxError = 0.0f;
+    for (int32 FieldIndex = 0; FieldIndex < NumFields; FieldIndex++)
+    {
+        MakeTestField(FieldIndex, Reference, SizeX, SizeY, SizeZ);
+        Separable = Reference;
+
+        SmoothReference(Reference, Temp, SizeX, SizeY, SizeZ, Passes);
+        Smooth(Separable, Buffers, SizeX, SizeY, SizeZ, Passes);
+
+        for (int32 Index = 0; Index < Reference.Num(); Index++)
+        {
+            MaxError = FMath::Max(MaxError, FMath::Abs(Reference[Index] - Separable[Index]));
+        }
+    }
+    return MaxError;
+}
+
+void FVoxelDensitySmoothing::RunBenchmark(int32 NumFields)
+{
+    NumFields = FMath::Max(NumFields, 1);
+
+    // Размеры поля плотности мешера: чанк + 1 точка + отступ 1 с каждой стороны
+    const int32 SizeX = VoxelConstants::ChunkSizeX + 3;
+    const int32 SizeY = VoxelConstants::ChunkSizeY + 3;
+    const int32 SizeZ = VoxelConstants::ChunkSizeZ + 1;
+
+    // Поля строятся заранее, чтобы в замер не попал шум
+    TArray<TArray<float>> Sources;
+    Sources.SetNum(NumFields);
+    for (int32 FieldIndex = 0; FieldIndex < NumFields; FieldIndex++)
+    {
+        MakeTestField(FieldIndex, Sources[FieldIndex], SizeX, SizeY, SizeZ);
+    }
+
+    TArray<float> Field;
+    TArray<float> Temp;
+    FBuffers Buffers;
+
+    for (int32 Passes = 1; Passes <= 3; Passes++)
+    {
+        double ReferenceSeconds = 0.0;
+        double SeparableSeconds = 0.0;
+        double Checksum = 0.0;
+
+        for (int32 FieldIndex = 0; FieldIndex < NumFields; FieldIndex++)
+        {
+            Field = Sources[FieldIndex];
+            double StartTime = FPlatformTime::Seconds();
+            SmoothReference(Field, Temp, SizeX, SizeY, SizeZ, Passes);
+            ReferenceSeconds += FPlatformTime::Seconds() - StartTime;
+            Checksum += Field[Field.Num() / 2];
+
+            Field = Sources[FieldIndex];
+            StartTime = FPlatformTime::Seconds();
+            Smooth(Field, Buffers, SizeX, SizeY, SizeZ, Passes);
+            SeparableSeconds += FPlatformTime::Seconds() - StartTime;
+            Checksum -= Field[Field.Num() / 2];
+        }
+
+        UE_LOG(LogTemp, Log, TEXT("Voxel smoothing benchmark: %d chunks, %d pass(es), reference %.3f ms/chunk, separable %.3f ms/chunk (%.2fx), max error %g, checksum delta %g"),
+               NumFields, Passes,
+               ReferenceSeconds * 1000.0 / NumFields, SeparableSeconds * 1000.0 / NumFields,
+               SeparableSeconds > 0.0 ? ReferenceSeconds / SeparableSeconds : 0.0,
+               MeasureError(FMath::Min(NumFields, 64), Passes), Checksum);
+    }
+}
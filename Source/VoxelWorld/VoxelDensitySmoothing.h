@@ -0,0 +1,46 @@
+// VoxelDensitySmoothing.h
+// Сглаживание поля плотности Marching Cubes: эталонный фильтр 3x3x3 и раздельный узкополосный (SIMD)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Фильтр одного прохода: точка у поверхности (|d| <= BandLimit, Z > 1) заменяется взвешенным
+// средним куба 3x3x3 (центр — вес 4, остальные — 1, точки за границей поля — значение -1).
+// Остальные точки не меняются.
+struct VOXELWORLD_API FVoxelDensitySmoothing
+{
+    static constexpr float BandLimit = 1.5f;
+
+    // Допустимое расхождение раздельного фильтра с эталоном за один проход: суммы
+    // складываются в другом порядке, результат отличается в последних знаках.
+    static constexpr float Tolerance = 1e-5f;
+
+    // Рабочие буферы раздельного фильтра, переиспользуются между вызовами
+    struct FBuffers
+    {
+        // Суммы по X для одного слоя Z
+        TArray<float> RowSums;
+        // Суммы 3x3 по XY для слоёв полосы (плюс слой над и под ней)
+        TArray<float> PlaneSums;
+    };
+
+    // Эталон: полный обход поля, 27 выборок с проверкой границ на каждую; Temp — буфер размера поля
+    static void SmoothReference(TArray<float>& Field, TArray<float>& Temp, int32 SizeX, int32 SizeY, int32 SizeZ, int32 Passes);
+
+    // Раздельный фильтр: суммы по X, затем по Y, затем по Z на VectorRegister4Float вдоль
+    // непрерывных строк, и только для слоёв Z, где есть точки у поверхности. Пишет на место.
+    static void Smooth(TArray<float>& Field, FBuffers& Buffers, int32 SizeX, int32 SizeY, int32 SizeZ, int32 Passes);
+
+    // Максимальное расхождение Smooth с эталоном на NumFields синтетических полях чанков
+    // (автотест VoxelWorld.Smoothing.Tolerance)
+    static float MeasureError(int32 NumFields, int32 Passes);
+
+    // Сравнить скорость эталона и раздельного фильтра при 1..3 проходах, результат в лог
+    static void RunBenchmark(int32 NumFields);
+
+private:
+    static void SmoothPass(TArray<float>& Field, FBuffers& Buffers, int32 SizeX, int32 SizeY, int32 SizeZ);
+    // Синтетическое поле плотности чанка (рельеф из шума, как в BuildDensityField без правок)
+    static void MakeTestField(int32 FieldIndex, TArray<float>& OutField, int32 SizeX, int32 SizeY, int32 SizeZ);
+};
@@ -0,0 +1,124 @@
+// VoxelHeightmapCache.cpp
+
+#include "VoxelHeightmapCache.h"
+#include "VoxelNoise.h"
+
+FVoxelHeightmapCache::FVoxelHeightmapCache(int32 InMaxTiles)
+    : Tiles(FMath::Max(InMaxTiles, 1))
+    , MaxTiles(FMath::Max(InMaxTiles, 1))
+{
+}
+
+FVoxelHeightTilePtr FVoxelHeightmapCache::GetTile(const FIntPoint& ChunkCoords)
+{
+    {
+        FScopeLock ScopeLock(&Lock);
+        if (const FVoxelHeightTilePtr* Found = Tiles.FindAndTouch(ChunkCoords))
+        {
+            NumHits++;
+            return *Found;
+        }
+    }
+
+    // Считаем без блокировки: другие потоки в это время читают свои тайлы.
+    // Если тот же тайл параллельно посчитал другой поток, результат тот же — просто перезапишем.
+    TSharedRef<FVoxelHeightTile, ESPMode::ThreadSafe> Tile = MakeShared<FVoxelHeightTile, ESPMode::ThreadSafe>();
+    FVoxelNoise::ComputeTile(ChunkCoords.X * VoxelConstants::ChunkSizeX, ChunkCoords.Y * VoxelConstants::ChunkSizeY,
+                             VoxelConstants::ChunkSizeX, VoxelConstants::ChunkSizeY, Tile->Noise);
+    for (int32 Index = 0; Index < FVoxelHeightTile::NumColumns; Index++)
+    {
+        Tile->SurfaceHeights[Index] = (uint8)FVoxelNoise::GetSurfaceHeight(Tile->Noise[Index]);
+    }
+
+    FScopeLock ScopeLock(&Lock);
+    NumMisses++;
+    FVoxelHeightTilePtr Result = Tile;
+    Tiles.Add(ChunkCoords, Result);
+    return Result;
+}
+
+float FVoxelHeightmapCache::GetNoise(int32 WorldX, int32 WorldY)
+{
+    const FIntPoint ChunkCoords = GetChunkCoords(WorldX, WorldY);
+    const FVoxelHeightTilePtr Tile = GetTile(ChunkCoords);
+    return Tile->Noise[FVoxelChunkData::GetColumnIndex(WorldX - ChunkCoords.X * VoxelConstants::ChunkSizeX,
+                                                       WorldY - ChunkCoords.Y * VoxelConstants::ChunkSizeY)];
+}
+
+int32 FVoxelHeightmapCache::GetSurfaceHeight(int32 WorldX, int32 WorldY)
+{
+    const FIntPoint ChunkCoords = GetChunkCoords(WorldX, WorldY);
+    const FVoxelHeightTilePtr Tile = GetTile(ChunkCoords);
+    return Tile->SurfaceHeights[FVoxelChunkData::GetColumnIndex(WorldX - ChunkCoords.X * VoxelConstants::ChunkSizeX,
+                                                                WorldY - ChunkCoords.Y * VoxelConstants::ChunkSizeY)];
+}
+
+void FVoxelHeightmapCache::GetNoiseRegion(int32 WorldStartX, int32 WorldStartY, int32 SizeX, int32 SizeY, float* OutValues)
+{
+    if (SizeX <= 0 || SizeY <= 0) return;
+
+    const FIntPoint FirstChunk = GetChunkCoords(WorldStartX, WorldStartY);
+    const FIntPoint LastChunk = GetChunkCoords(WorldStartX + SizeX - 1, WorldStartY + SizeY - 1);
+
+    // Копируем из каждого затронутого тайла его пересечение с прямоугольником построчно
+    for (int32 ChunkY = FirstChunk.Y; ChunkY <= LastChunk.Y; ChunkY++)
+    {
+        for (int32 ChunkX = FirstChunk.X; ChunkX <= LastChunk.X; ChunkX++)
+        {
+            const FVoxelHeightTilePtr Tile = GetTile(FIntPoint(ChunkX, ChunkY));
+            const int32 TileStartX = ChunkX * VoxelConstants::ChunkSizeX;
+            const int32 TileStartY = ChunkY * VoxelConstants::ChunkSizeY;
+
+            const int32 MinX = FMath::Max(WorldStartX, TileStartX);
+            const int32 MaxX = FMath::Min(WorldStartX + SizeX, TileStartX + VoxelConstants::ChunkSizeX);
+            const int32 MinY = FMath::Max(WorldStartY, TileStartY);
+            const int32 MaxY = FMath::Min(WorldStartY + SizeY, TileStartY + VoxelConstants::ChunkSizeY);
+
+            for (int32 Y = MinY; Y < MaxY; Y++)
+            {
+                FMemory::Memcpy(OutValues + (MinX - WorldStartX) + (Y - WorldStartY) * SizeX,
+                                Tile->Noise + FVoxelChunkData::GetColumnIndex(MinX - TileStartX, Y - TileStartY),
+                                (MaxX - MinX) * sizeof(float));
+            }
+        }
+    }
+}
+
+void FVoxelHeightmapCache::SetMaxTiles(int32 InMaxTiles)
+{
+    FScopeLock ScopeLock(&Lock);
+    MaxTiles = FMath::Max(InMaxTiles, 1);
+    Tiles.Empty(MaxTiles);
+}
+
+void FVoxelHeightmapCache::Empty()
+{
+    FScopeLock ScopeLock(&Lock);
+    Tiles.Empty(MaxTiles);
+    NumHits = 0;
+    NumMisses = 0;
+}
+
+int32 FVoxelHeightmapCache::Num() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return Tiles.Num();
+}
+
+uint64 FVoxelHeightmapCache::GetNumHits() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return NumHits;
+}
+
+uint64 FVoxelHeightmapCache::GetNumMisses() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return NumMisses;
+}
+
+SIZE_T FVoxelHeightmapCache::GetAllocatedSize() const
+{
+    FScopeLock ScopeLock(&Lock);
+    return (SIZE_T)Tiles.Num() * sizeof(FVoxelHeightTile);
+}
@@ -0,0 +1,63 @@
+// VoxelHeightmapCache.h
+// Кэш шума рельефа по тайлам чанков: каждый столбец мира считается один раз за сессию
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "VoxelChunkData.h"
+
+// Шум и высота поверхности всех столбцов одного чанка
+struct FVoxelHeightTile
+{
+    static constexpr int32 NumColumns = VoxelConstants::ChunkSizeX * VoxelConstants::ChunkSizeY;
+
+    // Индекс столбца — FVoxelChunkData::GetColumnIndex
+    float Noise[NumColumns];
+    uint8 SurfaceHeights[NumColumns];
+};
+
+typedef TSharedPtr<const FVoxelHeightTile, ESPMode::ThreadSafe> FVoxelHeightTilePtr;
+
+// Общий для мира кэш тайлов высот (генерация блоков, поле плотности, сглаживание,
+// блоки соседних чанков). Потокобезопасен; давно не использованные тайлы вытесняются (LRU).
+class VOXELWORLD_API FVoxelHeightmapCache
+{
+public:
+    static constexpr int32 DefaultMaxTiles = 4096;
+
+    explicit FVoxelHeightmapCache(int32 InMaxTiles = DefaultMaxTiles);
+
+    // Тайл чанка; при промахе считается пакетным FBM вне блокировки
+    FVoxelHeightTilePtr GetTile(const FIntPoint& ChunkCoords);
+
+    // Столбец мира в блоках
+    float GetNoise(int32 WorldX, int32 WorldY);
+    int32 GetSurfaceHeight(int32 WorldX, int32 WorldY);
+
+    // Прямоугольник столбцов мира (может захватывать соседние чанки): OutValues[i + j * SizeX]
+    void GetNoiseRegion(int32 WorldStartX, int32 WorldStartY, int32 SizeX, int32 SizeY, float* OutValues);
+
+    void SetMaxTiles(int32 InMaxTiles);
+    void Empty();
+
+    int32 Num() const;
+    uint64 GetNumHits() const;
+    uint64 GetNumMisses() const;
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    mutable FCriticalSection Lock;
+    TLruCache<FIntPoint, FVoxelHeightTilePtr> Tiles;
+    int32 MaxTiles;
+    uint64 NumHits = 0;
+    uint64 NumMisses = 0;
+
+    static FIntPoint GetChunkCoords(int32 WorldX, int32 WorldY)
+    {
+        return FIntPoint(FMath::DivideAndRoundDown(WorldX, VoxelConstants::ChunkSizeX),
+                         FMath::DivideAndRoundDown(WorldY, VoxelConstants::ChunkSizeY));
+    }
+};
+
+typedef TSharedRef<FVoxelHeightmapCache, ESPMode::ThreadSafe> FVoxelHeightmapCacheRef;
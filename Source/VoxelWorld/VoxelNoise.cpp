@@ -0,0 +1,291 @@
+// VoxelNoise.cpp
+
+#include "VoxelNoise.h"
+#include "VoxelChunkData.h"
+#include "Math/VectorRegister.h"
+
+// ============================================================
+// Perlin 2D — повторяет FMath::PerlinNoise2D операция в операцию
+// ============================================================
+
+namespace VoxelNoisePerlin
+{
+    // Перестановка Перлина — та же, что у FMath (сверяется в IsBatchValid)
+    static const uint8 Permutation[256] =
+    {
+        151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+        140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+        247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+         57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+         74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+         60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+         65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+        200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+         52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+        207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+        119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+        129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+         81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+        184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+        222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+    };
+
+    // Таблица FMath повторена дважды; здесь то же через & 255
+    FORCEINLINE int32 P(int32 Index) { return Permutation[Index & 255]; }
+
+    // Grad2 из FMath (switch по Hash & 7) как коэффициенты: Grad = GradX * X + GradY * Y.
+    // Коэффициенты 0/±1 — умножение точное, результат совпадает со switch.
+    static const float GradX[8] = { 1.0f, 1.0f, 0.0f, -1.0f, -1.0f, -1.0f,  0.0f,  1.0f };
+    static const float GradY[8] = { 0.0f, 1.0f, 1.0f,  1.0f,  0.0f, -1.0f, -1.0f, -1.0f };
+
+    // X * X * X * (X * (X * 6 - 15) + 10), тот же порядок операций, без FMA
+    FORCEINLINE VectorRegister4Float SmoothCurve(const VectorRegister4Float& X)
+    {
+        const VectorRegister4Float X3 = VectorMultiply(VectorMultiply(X, X), X);
+        const VectorRegister4Float Inner = VectorSubtract(VectorMultiply(X, VectorSetFloat1(6.0f)), VectorSetFloat1(15.0f));
+        return VectorMultiply(X3, VectorAdd(VectorMultiply(X, Inner), VectorSetFloat1(10.0f)));
+    }
+
+    // FMath::Lerp: A + Alpha * (B - A)
+    FORCEINLINE VectorRegister4Float Lerp(const VectorRegister4Float& A, const VectorRegister4Float& B, const VectorRegister4Float& Alpha)
+    {
+        return VectorAdd(A, VectorMultiply(Alpha, VectorSubtract(B, A)));
+    }
+
+    FORCEINLINE VectorRegister4Float Grad(const VectorRegister4Float& GX, const VectorRegister4Float& GY,
+                                          const VectorRegister4Float& X, const VectorRegister4Float& Y)
+    {
+        return VectorAdd(VectorMultiply(GX, X), VectorMultiply(GY, Y));
+    }
+
+    // 4 точки. Арифметика векторная; выборка из таблицы перестановки — по лейнам,
+    // переносимого gather в VectorRegister нет.
+    static VectorRegister4Float PerlinNoise2D4(const VectorRegister4Float& LocX, const VectorRegister4Float& LocY)
+    {
+        const VectorRegister4Float Xfl = VectorFloor(LocX);
+        const VectorRegister4Float Yfl = VectorFloor(LocY);
+        const VectorRegister4Float X = VectorSubtract(LocX, Xfl);
+        const VectorRegister4Float Y = VectorSubtract(LocY, Yfl);
+        const VectorRegister4Float One = VectorSetFloat1(1.0f);
+        const VectorRegister4Float Xm1 = VectorSubtract(X, One);
+        const VectorRegister4Float Ym1 = VectorSubtract(Y, One);
+
+        alignas(16) float XflLanes[4];
+        alignas(16) float YflLanes[4];
+        VectorStoreAligned(Xfl, XflLanes);
+        VectorStoreAligned(Yfl, YflLanes);
+
+        // Коэффициенты градиентов четырёх углов ячейки: AA, BA, AB, BB
+        alignas(16) float GX[4][4];
+        alignas(16) float GY[4][4];
+        for (int32 Lane = 0; Lane < 4; Lane++)
+        {
+            const int32 Xi = (int32)XflLanes[Lane] & 255;
+            const int32 Yi = (int32)YflLanes[Lane] & 255;
+            const int32 AA = P(Xi) + Yi;
+            const int32 BA = P(Xi + 1) + Yi;
+            const int32 Hashes[4] = { P(AA), P(BA), P(AA + 1), P(BA + 1) };
+            for (int32 Corner = 0; Corner < 4; Corner++)
+            {
+                GX[Corner][Lane] = GradX[Hashes[Corner] & 7];
+                GY[Corner][Lane] = GradY[Hashes[Corner] & 7];
+            }
+        }
+
+        const VectorRegister4Float U = SmoothCurve(X);
+        const VectorRegister4Float V = SmoothCurve(Y);
+
+        const VectorRegister4Float GradAA = Grad(VectorLoadAligned(GX[0]), VectorLoadAligned(GY[0]), X, Y);
+        const VectorRegister4Float GradBA = Grad(VectorLoadAligned(GX[1]), VectorLoadAligned(GY[1]), Xm1, Y);
+        const VectorRegister4Float GradAB = Grad(VectorLoadAligned(GX[2]), VectorLoadAligned(GY[2]), X, Ym1);
+        const VectorRegister4Float GradBB = Grad(VectorLoadAligned(GX[3]), VectorLoadAligned(GY[3]), Xm1, Ym1);
+
+        return Lerp(Lerp(GradAA, GradBA, U), Lerp(GradAB, GradBB, U), V);
+    }
+}
+
+// ============================================================
+// FBM
+// ============================================================
+
+float FVoxelNoise::FBM2D(float X, float Y)
+{
+    float Total = 0.0f;
+    float Frequency = 1.0f;
+    float Amplitude = 1.0f;
+    float MaxValue = 0.0f;
+
+    for (int32 Octave = 0; Octave < VoxelConstants::NoiseOctaves; ++Octave)
+    {
+        float Noise = FMath::PerlinNoise2D(FVector2D(X * Frequency, Y * Frequency));
+        Total += Noise * Amplitude;
+        MaxValue += Amplitude;
+
+        Amplitude *= VoxelConstants::NoisePersistence;
+        Frequency *= VoxelConstants::NoiseLacunarity;
+    }
+
+    return Total / MaxValue;
+}
+
+void FVoxelNoise::FBM2DBatchSIMD(const float* X, const float* Y, float* OutValues, int32 Num)
+{
+    int32 Index = 0;
+    for (; Index + 4 <= Num; Index += 4)
+    {
+        const VectorRegister4Float PX = VectorLoad(X + Index);
+        const VectorRegister4Float PY = VectorLoad(Y + Index);
+
+        VectorRegister4Float Total = VectorZero();
+        float Frequency = 1.0f;
+        float Amplitude = 1.0f;
+        float MaxValue = 0.0f;
+
+        for (int32 Octave = 0; Octave < VoxelConstants::NoiseOctaves; ++Octave)
+        {
+            const VectorRegister4Float Freq = VectorSetFloat1(Frequency);
+            const VectorRegister4Float Noise = VoxelNoisePerlin::PerlinNoise2D4(VectorMultiply(PX, Freq), VectorMultiply(PY, Freq));
+            Total = VectorAdd(Total, VectorMultiply(Noise, VectorSetFloat1(Amplitude)));
+            MaxValue += Amplitude;
+
+            Amplitude *= VoxelConstants::NoisePersistence;
+            Frequency *= VoxelConstants::NoiseLacunarity;
+        }
+
+        VectorStore(VectorDivide(Total, VectorSetFloat1(MaxValue)), OutValues + Index);
+    }
+
+    for (; Index < Num; Index++)
+    {
+        OutValues[Index] = FBM2D(X[Index], Y[Index]);
+    }
+}
+
+bool FVoxelNoise::IsBatchValid()
+{
+    // Один раз на процесс: если таблица или арифметика разошлись с FMath — работаем по эталону
+    static const bool bValid = []()
+    {
+        const float MaxError = MeasureBatchError(4096);
+        if (MaxError > BatchTolerance)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Voxel noise: batch FBM differs from FMath::PerlinNoise2D by %g, using scalar path"), MaxError);
+            return false;
+        }
+        return true;
+    }();
+    return bValid;
+}
+
+void FVoxelNoise::FBM2DBatch(const float* X, const float* Y, float* OutValues, int32 Num)
+{
+    if (!IsBatchValid())
+    {
+        for (int32 Index = 0; Index < Num; Index++)
+        {
+            OutValues[Index] = FBM2D(X[Index], Y[Index]);
+        }
+        return;
+    }
+
+    FBM2DBatchSIMD(X, Y, OutValues, Num);
+}
+
+void FVoxelNoise::ComputeTile(int32 WorldStartX, int32 WorldStartY, int32 SizeX, int32 SizeY, float* OutValues)
+{
+    const int32 Num = SizeX * SizeY;
+    TArray<float, TInlineAllocator<32 * 32>> CoordX;
+    TArray<float, TInlineAllocator<32 * 32>> CoordY;
+    CoordX.SetNumUninitialized(Num);
+    CoordY.SetNumUninitialized(Num);
+
+    for (int32 Y = 0; Y < SizeY; Y++)
+    {
+        for (int32 X = 0; X < SizeX; X++)
+        {
+            CoordX[X + Y * SizeX] = (float)(WorldStartX + X) * VoxelConstants::NoiseScale;
+            CoordY[X + Y * SizeX] = (float)(WorldStartY + Y) * VoxelConstants::NoiseScale;
+        }
+    }
+
+    FBM2DBatch(CoordX.GetData(), CoordY.GetData(), OutValues, Num);
+}
+
+float FVoxelNoise::GetContinuousHeight(float NoiseValue)
+{
+    return VoxelConstants::HeightBase + NoiseValue * VoxelConstants::HeightAmplitude;
+}
+
+int32 FVoxelNoise::GetSurfaceHeight(float NoiseValue)
+{
+    return FMath::Clamp(FMath::RoundToInt(GetContinuousHeight(NoiseValue)), 1, VoxelConstants::ChunkSizeZ - 1);
+}
+
+// ============================================================
+// Validation / benchmark
+// ============================================================
+
+float FVoxelNoise::MeasureBatchError(int32 NumSamples)
+{
+    // Точки по обе стороны от нуля и за периодом таблицы (256 ячеек на частоте 1)
+    FRandomStream Random(1337);
+    TArray<float> X, Y, Batch;
+    X.SetNumUninitialized(NumSamples);
+    Y.SetNumUninitialized(NumSamples);
+    Batch.SetNumUninitialized(NumSamples);
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        X[Index] = (float)Random.RandRange(-100000, 100000) * VoxelConstants::NoiseScale;
+        Y[Index] = (float)Random.RandRange(-100000, 100000) * VoxelConstants::NoiseScale;
+    }
+
+    FBM2DBatchSIMD(X.GetData(), Y.GetData(), Batch.GetData(), NumSamples);
+
+    float MaxError = 0.0f;
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        MaxError = FMath::Max(MaxError, FMath::Abs(Batch[Index] - FBM2D(X[Index], Y[Index])));
+    }
+    return MaxError;
+}
+
+void FVoxelNoise::RunBenchmark(int32 NumTiles)
+{
+    NumTiles = FMath::Max(NumTiles, 1);
+    constexpr int32 TileSize = VoxelConstants::ChunkSizeX;
+    static_assert(VoxelConstants::ChunkSizeX == VoxelConstants::ChunkSizeY, "Benchmark tiles are square chunks");
+
+    float Tile[TileSize * TileSize];
+    double Checksum = 0.0;
+
+    double StartTime = FPlatformTime::Seconds();
+    for (int32 TileIndex = 0; TileIndex < NumTiles; TileIndex++)
+    {
+        const int32 StartX = (TileIndex % 64) * TileSize;
+        const int32 StartY = (TileIndex / 64) * TileSize;
+        for (int32 Y = 0; Y < TileSize; Y++)
+        {
+            for (int32 X = 0; X < TileSize; X++)
+            {
+                Tile[X + Y * TileSize] = FBM2D((float)(StartX + X) * VoxelConstants::NoiseScale,
+                                               (float)(StartY + Y) * VoxelConstants::NoiseScale);
+            }
+        }
+        Checksum += Tile[0];
+    }
+    const double ScalarSeconds = FPlatformTime::Seconds() - StartTime;
+
+    StartTime = FPlatformTime::Seconds();
+    for (int32 TileIndex = 0; TileIndex < NumTiles; TileIndex++)
+    {
+        ComputeTile((TileIndex % 64) * TileSize, (TileIndex / 64) * TileSize, TileSize, TileSize, Tile);
+        Checksum -= Tile[0];
+    }
+    const double BatchSeconds = FPlatformTime::Seconds() - StartTime;
+
+    UE_LOG(LogTemp, Log, TEXT("Voxel noise benchmark: %d tiles, scalar %.2f ms, batch %.2f ms (%.2fx), max error %g, checksum delta %g, batch %s"),
+           NumTiles, ScalarSeconds * 1000.0, BatchSeconds * 1000.0,
+           BatchSeconds > 0.0 ? ScalarSeconds / BatchSeconds : 0.0,
+           MeasureBatchError(4096), Checksum, IsBatchValid() ? TEXT("enabled") : TEXT("disabled"));
+}
@@ -0,0 +1,39 @@
+// VoxelNoise.h
+// FBM-шум рельефа: скалярный эталон и пакетное вычисление целого тайла высот (SIMD)
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct VOXELWORLD_API FVoxelNoise
+{
+    // Допустимое расхождение пакетного пути с эталоном. На x64 без FMA (сборка UE по умолчанию)
+    // результат совпадает бит в бит; на платформах, где компилятор сливает a + b * c в FMA,
+    // возможна разница в последнем знаке.
+    static constexpr float BatchTolerance = 1e-5f;
+
+    // Эталон: FBM на FMath::PerlinNoise2D, результат в (-1, 1)
+    static float FBM2D(float X, float Y);
+
+    // FBM для Num точек: 4 точки за раз на VectorRegister4Float, хвост — скалярно.
+    // Если проверка при первом вызове не прошла, все точки считаются через FBM2D.
+    static void FBM2DBatch(const float* X, const float* Y, float* OutValues, int32 Num);
+
+    // Тайл SizeX x SizeY шума для мировых блоков (StartX + i, StartY + j) с масштабом NoiseScale.
+    // OutValues[i + j * SizeX]; координаты считаются так же, как в скалярном пути генерации.
+    static void ComputeTile(int32 WorldStartX, int32 WorldStartY, int32 SizeX, int32 SizeY, float* OutValues);
+
+    // Высота поверхности для значения шума (непрерывная и округлённая до блока)
+    static float GetContinuousHeight(float NoiseValue);
+    static int32 GetSurfaceHeight(float NoiseValue);
+
+    // Максимальное расхождение пакетного пути с эталоном на NumSamples точках
+    static float MeasureBatchError(int32 NumSamples);
+
+    // Сравнить скорость эталона и пакетного пути на NumTiles тайлах 16x16, результат в лог
+    static void RunBenchmark(int32 NumTiles);
+
+private:
+    static void FBM2DBatchSIMD(const float* X, const float* Y, float* OutValues, int32 Num);
+    static bool IsBatchValid();
+};
@@ -0,0 +1,230 @@
+// VoxelPackedMesh.cpp
+
+#include "VoxelPackedMesh.h"
+#include "VoxelChunkData.h"
+
+// Поле Normal: биты 14-15 — проекция UV (PackedProjection*), биты 0-13 — её данные.
+// Грань блока: индекс грани в битах 0-2, бит 3 — тайл маленького блока.
+// Сглаженная поверхность: октаэдрическая нормаль (U — биты 0..6, V — биты 7..13).
+static constexpr int32 PackedProjectionShift = 14;
+static constexpr uint16 PackedDataMask = (1 << PackedProjectionShift) - 1;
+static constexpr uint16 PackedProjectionZ = 0;
+static constexpr uint16 PackedProjectionX = 1;
+static constexpr uint16 PackedProjectionY = 2;
+static constexpr uint16 PackedProjectionFace = 3;
+static constexpr uint16 PackedSmallTileFlag = 0x0008;
+static constexpr int32 PackedOctahedralMax = 126;
+
+// Нормали граней в порядке FaceNormals мешера
+static const FVector3f PackedFaceNormals[6] = {
+    FVector3f(0, 0, 1), FVector3f(0, 0, -1),
+    FVector3f(1, 0, 0), FVector3f(-1, 0, 0),
+    FVector3f(0, 1, 0), FVector3f(0, -1, 0)
+};
+
+static uint16 GetPackedProjection(const FVoxelPackedVertex& Vertex)
+{
+    return Vertex.Normal >> PackedProjectionShift;
+}
+
+// ============================================================
+// Кодирование
+// ============================================================
+
+uint16 FVoxelPackedMesh::EncodePosition(double Position)
+{
+    const double Units = (Position / VoxelConstants::BlockSize - PositionOriginBlocks) * PositionUnitsPerBlock;
+    return (uint16)FMath::Clamp(FMath::RoundToInt(Units), 0, (int32)MAX_uint16);
+}
+
+FVoxelPackedVertex FVoxelPackedMesh::MakeFaceVertex(const FVector& Position, int32 Face, bool bSmallTile, FColor Color)
+{
+    checkSlow(Face >= 0 && Face < 6);
+    FVoxelPackedVertex Vertex;
+    Vertex.Position[0] = EncodePosition(Position.X);
+    Vertex.Position[1] = EncodePosition(Position.Y);
+    Vertex.Position[2] = EncodePosition(Position.Z);
+    Vertex.Normal = (uint16)((PackedProjectionFace << PackedProjectionShift) | Face | (bSmallTile ? PackedSmallTileFlag : 0));
+    Vertex.Color = Color;
+    return Vertex;
+}
+
+FVoxelPackedVertex FVoxelPackedMesh::MakeSmoothVertex(const FVector& Position, const FVector& Normal, FColor Color)
+{
+    const FVector AbsNormal = Normal.GetAbs();
+    uint16 Projection = PackedProjectionY;
+    if (AbsNormal.Z >= AbsNormal.X && AbsNormal.Z >= AbsNormal.Y)
+    {
+        Projection = PackedProjectionZ;
+    }
+    else if (AbsNormal.X >= AbsNormal.Y)
+    {
+        Projection = PackedProjectionX;
+    }
+
+    FVoxelPackedVertex Vertex;
+    Vertex.Position[0] = EncodePosition(Position.X);
+    Vertex.Position[1] = EncodePosition(Position.Y);
+    Vertex.Position[2] = EncodePosition(Position.Z);
+    Vertex.Normal = (uint16)((Projection << PackedProjectionShift) | EncodeOctahedral(FVector3f(Normal)));
+    Vertex.Color = Color;
+    return Vertex;
+}
+
+uint16 FVoxelPackedMesh::EncodeOctahedral(const FVector3f& Normal)
+{
+    FVector3f N = Normal / FMath::Max(FMath::Abs(Normal.X) + FMath::Abs(Normal.Y) + FMath::Abs(Normal.Z), UE_SMALL_NUMBER);
+    float U = N.X;
+    float V = N.Y;
+    if (N.Z < 0.0f)
+    {
+        U = (1.0f - FMath::Abs(N.Y)) * (N.X >= 0.0f ? 1.0f : -1.0f);
+        V = (1.0f - FMath::Abs(N.X)) * (N.Y >= 0.0f ? 1.0f : -1.0f);
+    }
+    const int32 QU = FMath::Clamp(FMath::RoundToInt((U + 1.0f) * 0.5f * PackedOctahedralMax), 0, PackedOctahedralMax);
+    const int32 QV = FMath::Clamp(FMath::RoundToInt((V + 1.0f) * 0.5f * PackedOctahedralMax), 0, PackedOctahedralMax);
+    return (uint16)(QU | (QV << 7));
+}
+
+FVector3f FVoxelPackedMesh::DecodeOctahedral(uint16 Encoded)
+{
+    const float U = (Encoded & 0x7F) * (2.0f / PackedOctahedralMax) - 1.0f;
+    const float V = ((Encoded >> 7) & 0x7F) * (2.0f / PackedOctahedralMax) - 1.0f;
+    FVector3f N(U, V, 1.0f - FMath::Abs(U) - FMath::Abs(V));
+    if (N.Z < 0.0f)
+    {
+        N.X = (1.0f - FMath::Abs(V)) * (U >= 0.0f ? 1.0f : -1.0f);
+        N.Y = (1.0f - FMath::Abs(U)) * (V >= 0.0f ? 1.0f : -1.0f);
+    }
+    return N.GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector);
+}
+
+FVector2f FVoxelPackedMesh::GetFaceUV(const FVector3f& Position, int32 Face, float TileSize)
+{
+    // Оси U / V граней — как в FVoxelChunkMesher::AddBoxFaceToSection
+    const FVector3f P = Position / TileSize;
+    switch (Face)
+    {
+    case 0:  return FVector2f(P.X, P.Y);
+    case 1:  return FVector2f(P.Y, P.X);
+    case 2:  return FVector2f(P.Y, P.Z);
+    case 3:  return FVector2f(P.Z, P.Y);
+    case 4:  return FVector2f(P.Z, P.X);
+    default: return FVector2f(P.X, P.Z);
+    }
+}
+
+// ============================================================
+// Распаковка
+// ============================================================
+
+FVector3f FVoxelPackedMesh::DecodePosition(const FVoxelPackedVertex& Vertex)
+{
+    const float Scale = VoxelConstants::BlockSize / PositionUnitsPerBlock;
+    const float Origin = PositionOriginBlocks * VoxelConstants::BlockSize;
+    return FVector3f(
+        Vertex.Position[0] * Scale + Origin,
+        Vertex.Position[1] * Scale + Origin,
+        Vertex.Position[2] * Scale + Origin);
+}
+
+FVector3f FVoxelPackedMesh::DecodeNormal(const FVoxelPackedVertex& Vertex)
+{
+    if (GetPackedProjection(Vertex) == PackedProjectionFace)
+    {
+        return PackedFaceNormals[FMath::Min(Vertex.Normal & 0x7, 5)];
+    }
+    return DecodeOctahedral(Vertex.Normal & PackedDataMask);
+}
+
+FVector2f FVoxelPackedMesh::DecodeUV(const FVoxelPackedVertex& Vertex)
+{
+    // UV — от распакованной позиции: текстура следует за той геометрией, что рисуется
+    const FVector3f Position = DecodePosition(Vertex);
+    const float BS = VoxelConstants::BlockSize;
+    switch (GetPackedProjection(Vertex))
+    {
+    case PackedProjectionZ: return FVector2f(Position.X / BS, Position.Y / BS);
+    case PackedProjectionX: return FVector2f(Position.Y / BS, Position.Z / BS);
+    case PackedProjectionY: return FVector2f(Position.X / BS, Position.Z / BS);
+    default:
+        {
+            const float TileSize = (Vertex.Normal & PackedSmallTileFlag) ? VoxelConstants::PlayerBlockSize : BS;
+            return GetFaceUV(Position, FMath::Min(Vertex.Normal & 0x7, 5), TileSize);
+        }
+    }
+}
+
+// ============================================================
+// Самопроверка
+// ============================================================
+
+FVoxelPackedMeshTestResult FVoxelPackedMesh::RunSelfTest(int32 NumVertices)
+{
+    NumVertices = FMath::Max(NumVertices, 4) & ~3;
+    const float BS = VoxelConstants::BlockSize;
+    const float PBS = VoxelConstants::PlayerBlockSize;
+    FRandomStream Random(1234);
+
+    // Половина — углы граней больших и маленьких блоков (на сетке своего тайла, как у мешера),
+    // половина — вершины сглаженной поверхности со случайной нормалью.
+    // Для каждой вершины запоминаются исходные позиция, нормаль и UV.
+    TArray<FVoxelPackedVertex> Packed;
+    TArray<FVector> Positions;
+    TArray<FVector> Normals;
+    TArray<FVector2f> UVs;
+    Packed.Reserve(NumVertices);
+    Positions.Reserve(NumVertices);
+    Normals.Reserve(NumVertices);
+    UVs.Reserve(NumVertices);
+    for (int32 Index = 0; Index < NumVertices; Index++)
+    {
+        if (Index < NumVertices / 2)
+        {
+            const bool bSmall = (Index & 1) != 0;
+            const float TileSize = bSmall ? PBS : BS;
+            const int32 Face = Random.RandRange(0, 5);
+            const FVector Position(Random.RandRange(0, 64) * PBS, Random.RandRange(0, 64) * PBS, Random.RandRange(0, 128) * PBS);
+            Packed.Add(MakeFaceVertex(Position, Face, bSmall, FColor((uint8)Random.RandRange(0, 255), 128, 64)));
+            Positions.Add(Position);
+            Normals.Add(FVector(PackedFaceNormals[Face]));
+            UVs.Add(GetFaceUV(FVector3f(Position), Face, TileSize));
+        }
+        else
+        {
+            const FVector Position(Random.FRandRange(0.0f, 16.0f * BS), Random.FRandRange(0.0f, 16.0f * BS), Random.FRandRange(0.0f, 32.0f * BS));
+            const FVector Normal = Random.GetUnitVector();
+            const FVector AbsNormal = Normal.GetAbs();
+            const FVector3f P(Position);
+            Packed.Add(MakeSmoothVertex(Position, Normal, FColor::White));
+            Positions.Add(Position);
+            Normals.Add(Normal);
+            if (AbsNormal.Z >= AbsNormal.X && AbsNormal.Z >= AbsNormal.Y)
+                UVs.Add(FVector2f(P.X / BS, P.Y / BS));
+            else if (AbsNormal.X >= AbsNormal.Y)
+                UVs.Add(FVector2f(P.Y / BS, P.Z / BS));
+            else
+                UVs.Add(FVector2f(P.X / BS, P.Z / BS));
+        }
+    }
+
+    FVoxelPackedMeshTestResult Result;
+    Result.NumVertices = Packed.Num();
+    Result.BytesPerVertex = (int32)sizeof(FVoxelPackedVertex);
+    Result.PackedBytes = Packed.GetAllocatedSize();
+    Result.UnpackedBytes = Packed.Num() * UnpackedVertexSize;
+    for (int32 Index = 0; Index < Packed.Num(); Index++)
+    {
+        Result.MaxPositionError = FMath::Max(Result.MaxPositionError, (DecodePosition(Packed[Index]) - FVector3f(Positions[Index])).GetAbsMax());
+        const float Cos = FVector3f::DotProduct(DecodeNormal(Packed[Index]), FVector3f(Normals[Index]));
+        Result.MaxNormalErrorDeg = FMath::Max(Result.MaxNormalErrorDeg, FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Cos, -1.0f, 1.0f))));
+        float& MaxUVError = Index < NumVertices / 2 ? Result.MaxFaceUVError : Result.MaxSmoothUVError;
+        MaxUVError = FMath::Max(MaxUVError, (DecodeUV(Packed[Index]) - UVs[Index]).GetAbsMax());
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("Voxel packed mesh: %d vertices, %d bytes/vertex (was %d), %.1f KB vs %.1f KB, max position error %.3f cm, max normal error %.2f deg, max UV error %.5f faces / %.5f smooth"),
+           Result.NumVertices, Result.BytesPerVertex, (int32)UnpackedVertexSize,
+           Result.PackedBytes / 1024.0, Result.UnpackedBytes / 1024.0,
+           Result.MaxPositionError, Result.MaxNormalErrorDeg, Result.MaxFaceUVError, Result.MaxSmoothUVError);
+    return Result;
+}
@@ -0,0 +1,81 @@
+// VoxelPackedMesh.h
+// Упакованный формат вершин меша чанка (12 байт) и секции в нём: кодирование вершин мешером,
+// распаковка, учёт памяти. Не зависит от рендера и UObject — проверяется без RHI (Voxel.PackedMeshTest).
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Вершина чанка: 12 байт вместо FVector + FVector + FVector2D + FColor (68 байт) прежнего мешера.
+// UV не хранятся — восстанавливаются из позиции и способа проекции в поле Normal (FVoxelPackedMesh::DecodeUV).
+struct FVoxelPackedVertex
+{
+    // Позиция в локальных координатах чанка: фиксированная точка, PositionUnitsPerBlock единиц на блок
+    // от PositionOriginBlocks
+    uint16 Position[3];
+    // Биты 14-15 — проекция UV. Грань блока: индекс грани (биты 0-2) и тайл маленького блока (бит 3).
+    // Сглаженная поверхность: плоскость проекции и октаэдрическая нормаль 7 + 7 бит.
+    uint16 Normal;
+    FColor Color;
+};
+static_assert(sizeof(FVoxelPackedVertex) == 12, "Packed chunk vertex must stay 12 bytes");
+
+// Секция меша одного материала в упакованном виде
+struct FVoxelPackedMeshSection
+{
+    TArray<FVoxelPackedVertex> Vertices;
+    TArray<uint32> Indices;
+    // Границы распакованных позиций, в локальных координатах чанка
+    FBox3f Bounds = FBox3f(ForceInit);
+
+    bool IsEmpty() const { return Indices.Num() == 0; }
+    SIZE_T GetAllocatedSize() const { return Vertices.GetAllocatedSize() + Indices.GetAllocatedSize(); }
+};
+
+// Итог самопроверки упаковки: размер вершины и наибольшие погрешности распаковки
+struct FVoxelPackedMeshTestResult
+{
+    int32 NumVertices = 0;
+    int32 BytesPerVertex = 0;
+    SIZE_T PackedBytes = 0;
+    SIZE_T UnpackedBytes = 0;
+    // Позиция — в сантиметрах, нормаль — в градусах, UV — в тайлах
+    float MaxPositionError = 0.0f;
+    float MaxNormalErrorDeg = 0.0f;
+    float MaxFaceUVError = 0.0f;
+    float MaxSmoothUVError = 0.0f;
+};
+
+struct VOXELWORLD_API FVoxelPackedMesh
+{
+    // 1/256 блока = 0.3 см; диапазон 256 блоков от -8 (юбки LOD и ячейки соседа уходят за ноль)
+    static constexpr int32 PositionUnitsPerBlock = 256;
+    static constexpr int32 PositionOriginBlocks = -8;
+
+    // Вершина прежнего мешера (позиция, нормаль, UV, цвет) — для сравнения в статистике
+    static constexpr SIZE_T UnpackedVertexSize = sizeof(FVector) * 2 + sizeof(FVector2D) + sizeof(FColor);
+
+    // Вершина грани блока Face (порядок FaceNormals мешера). UV — проекция по осям грани
+    // с тайлом маленького или большого блока: углы граней лежат на сетке тайлов, и UV точные.
+    static FVoxelPackedVertex MakeFaceVertex(const FVector& Position, int32 Face, bool bSmallTile, FColor Color);
+    // Вершина сглаженной поверхности. UV — проекция на плоскость, ближайшую к Normal, в тайлах блока;
+    // плоскость выбирается по исходной нормали, а не по квантованной.
+    static FVoxelPackedVertex MakeSmoothVertex(const FVector& Position, const FVector& Normal, FColor Color);
+
+    // Одна координата позиции в единицах упаковки (с ограничением диапазона)
+    static uint16 EncodePosition(double Position);
+
+    static FVector3f DecodePosition(const FVoxelPackedVertex& Vertex);
+    static FVector3f DecodeNormal(const FVoxelPackedVertex& Vertex);
+    static FVector2f DecodeUV(const FVoxelPackedVertex& Vertex);
+
+    // Упаковать и распаковать синтетические вершины (грани блоков и сглаженная поверхность),
+    // вывести в лог погрешности и размер вершины
+    static FVoxelPackedMeshTestResult RunSelfTest(int32 NumVertices);
+
+private:
+    static uint16 EncodeOctahedral(const FVector3f& Normal);
+    static FVector3f DecodeOctahedral(uint16 Encoded);
+    // UV грани блока Face при размере тайла TileSize
+    static FVector2f GetFaceUV(const FVector3f& Position, int32 Face, float TileSize);
+};
@@ -0,0 +1,173 @@
+// VoxelPaletteStorage.cpp
+
+#include "VoxelPaletteStorage.h"
+
+FVoxelPaletteStorage::FVoxelPaletteStorage(int32 InNumEntries, uint16 InitialValue)
+{
+    Init(InNumEntries, InitialValue);
+}
+
+void FVoxelPaletteStorage::Init(int32 InNumEntries, uint16 InitialValue)
+{
+    NumEntries = InNumEntries;
+    BitsPerEntry = 0;
+
+    Palette.Reset();
+    Palette.Add(InitialValue);
+
+    Data.Reset();
+    Data.SetNumZeroed(NumWordsFor(NumEntries, BitsPerEntry));
+}
+
+void FVoxelPaletteStorage::Set(int32 Index, uint16 Value)
+{
+    check(Index >= 0 && Index < NumEntries);
+    SetPaletteIndex(Index, FindOrAddPaletteIndex(Value));
+}
+
+void FVoxelPaletteStorage::SetPaletteIndex(int32 Index, uint32 PaletteIndex)
+{
+    const int32 BitOffset = Index * BitsPerEntry;
+    const uint64 Mask = (1ull << BitsPerEntry) - 1;
+    uint64& Word = Data[BitOffset >> 6];
+    Word = (Word & ~(Mask << (BitOffset & 63))) | ((uint64)PaletteIndex << (BitOffset & 63));
+}
+
+int32 FVoxelPaletteStorage::FindOrAddPaletteIndex(uint16 Value)
+{
+    // Палитра чанка обычно 3-4 элемента, линейный поиск быстрее хеша
+    const int32 Existing = Palette.Find(Value);
+    if (Existing != INDEX_NONE)
+    {
+        return Existing;
+    }
+
+    const int32 NewIndex = Palette.Add(Value);
+    if (NewIndex >= (1 << BitsPerEntry))
+    {
+        checkf(BitsPerEntry < MaxBitsPerEntry, TEXT("Voxel palette overflow (%d entries)"), Palette.Num());
+        Repack(BitsPerEntry == 0 ? 1 : BitsPerEntry * 2);
+    }
+    return NewIndex;
+}
+
+void FVoxelPaletteStorage::Repack(int32 NewBitsPerEntry)
+{
+    TArray<uint64> OldData = MoveTemp(Data);
+    const int32 OldBits = BitsPerEntry;
+    const uint64 OldMask = (1ull << OldBits) - 1;
+
+    BitsPerEntry = NewBitsPerEntry;
+    Data.SetNumZeroed(NumWordsFor(NumEntries, BitsPerEntry));
+
+    for (int32 i = 0; i < NumEntries; i++)
+    {
+        const int32 OldOffset = i * OldBits;
+        const uint32 PaletteIndex = (uint32)((OldData[OldOffset >> 6] >> (OldOffset & 63)) & OldMask);
+        if (PaletteIndex != 0)
+        {
+            SetPaletteIndex(i, PaletteIndex);
+        }
+    }
+}
+
+void FVoxelPaletteStorage::Compact()
+{
+    if (IsUniform()) return;
+
+    // Какие индексы палитры реально используются
+    TArray<int32> Remap;
+    Remap.Init(INDEX_NONE, Palette.Num());
+    for (int32 i = 0; i < NumEntries; i++)
+    {
+        Remap[GetPaletteIndex(i)] = 0;
+    }
+
+    TArray<uint16> NewPalette;
+    for (int32 Old = 0; Old < Palette.Num(); Old++)
+    {
+        if (Remap[Old] != INDEX_NONE)
+        {
+            Remap[Old] = NewPalette.Add(Palette[Old]);
+        }
+    }
+
+    if (NewPalette.Num() == 1)
+    {
+        Init(NumEntries, NewPalette[0]);
+        return;
+    }
+
+    int32 NewBits = 1;
+    while ((1 << NewBits) < NewPalette.Num())
+    {
+        NewBits *= 2;
+    }
+    if (NewPalette.Num() == Palette.Num() && NewBits == BitsPerEntry) return;
+
+    TArray<uint32> Indices;
+    Indices.SetNumUninitialized(NumEntries);
+    for (int32 i = 0; i < NumEntries; i++)
+    {
+        Indices[i] = (uint32)Remap[GetPaletteIndex(i)];
+    }
+
+    Palette = MoveTemp(NewPalette);
+    BitsPerEntry = NewBits;
+    Data.Reset();
+    Data.SetNumZeroed(NumWordsFor(NumEntries, BitsPerEntry));
+    for (int32 i = 0; i < NumEntries; i++)
+    {
+        SetPaletteIndex(i, Indices[i]);
+    }
+}
+
+bool FVoxelPaletteStorage::RemapValues(TConstArrayView<uint16> Remap)
+{
+    for (uint16 Value : Palette)
+    {
+        if (Value >= Remap.Num() || Remap[Value] == MAX_uint16) return false;
+    }
+    for (uint16& Value : Palette)
+    {
+        Value = Remap[Value];
+    }
+    return true;
+}
+
+SIZE_T FVoxelPaletteStorage::GetAllocatedSize() const
+{
+    return Palette.GetAllocatedSize() + Data.GetAllocatedSize();
+}
+
+FArchive& operator<<(FArchive& Ar, FVoxelPaletteStorage& Storage)
+{
+    Ar << Storage.NumEntries;
+    Ar << Storage.BitsPerEntry;
+    Ar << Storage.Palette;
+    Ar << Storage.Data;
+
+    if (Ar.IsLoading())
+    {
+        // Палитра всегда помещается в разрядность, данные — ровно NumWordsFor слов
+        bool bValid = !Ar.IsError() &&
+                      Storage.NumEntries >= 0 &&
+                      (Storage.BitsPerEntry == 0 ||
+                       (FMath::IsPowerOfTwo(Storage.BitsPerEntry) && Storage.BitsPerEntry <= FVoxelPaletteStorage::MaxBitsPerEntry)) &&
+                      Storage.Palette.Num() >= 1 &&
+                      Storage.Palette.Num() <= (1 << Storage.BitsPerEntry) &&
+                      Storage.Data.Num() == FVoxelPaletteStorage::NumWordsFor(Storage.NumEntries, Storage.BitsPerEntry);
+
+        for (int32 i = 0; bValid && i < Storage.NumEntries; i++)
+        {
+            bValid = Storage.GetPaletteIndex(i) < (uint32)Storage.Palette.Num();
+        }
+
+        if (!bValid)
+        {
+            Ar.SetError();
+            Storage.Init(FMath::Max(Storage.NumEntries, 0));
+        }
+    }
+    return Ar;
+}
@@ -0,0 +1,81 @@
+// VoxelPaletteStorage.h
+// Палитровое хранилище вокселей: палитра уникальных значений + упакованные индексы
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Значения — runtime ID блоков из UVoxelDatabase (0 = воздух).
+// Хранит NumEntries значений как индексы в палитре, упакованные в uint64-слова.
+// Разрядность индекса растёт 0/1/2/4/8/16 бит по мере роста палитры;
+// все разрядности делят 64, поэтому индекс никогда не пересекает границу слова.
+// 0 бит — однородное хранилище: одно значение в палитре и одно нулевое слово данных.
+class VOXELWORLD_API FVoxelPaletteStorage
+{
+public:
+    static constexpr int32 MaxBitsPerEntry = 16;
+
+    FVoxelPaletteStorage() = default;
+    explicit FVoxelPaletteStorage(int32 InNumEntries, uint16 InitialValue = 0);
+
+    // Сбросить хранилище: все записи = InitialValue (однородный режим)
+    void Init(int32 InNumEntries, uint16 InitialValue = 0);
+
+    // Убрать неиспользуемые значения палитры и уменьшить разрядность;
+    // если осталось одно значение — перейти в однородный режим
+    void Compact();
+
+    FORCEINLINE uint16 Get(int32 Index) const
+    {
+        return Palette[GetPaletteIndex(Index)];
+    }
+
+    void Set(int32 Index, uint16 Value);
+
+    int32 GetNumEntries() const { return NumEntries; }
+    int32 GetPaletteSize() const { return Palette.Num(); }
+    int32 GetBitsPerEntry() const { return BitsPerEntry; }
+
+    bool IsUniform() const { return BitsPerEntry == 0; }
+    // Значение однородного хранилища (только при IsUniform())
+    uint16 GetUniformValue() const { return Palette[0]; }
+
+    // Память, занятая палитрой и упакованными индексами (в байтах)
+    SIZE_T GetAllocatedSize() const;
+
+    // Все значения палитры (включая неиспользуемые до Compact)
+    TConstArrayView<uint16> GetPaletteValues() const { return Palette; }
+
+    // Заменить каждое значение палитры на Remap[Value]. false — значение вне Remap
+    // или Remap[Value] == MAX_uint16; хранилище тогда не меняется.
+    bool RemapValues(TConstArrayView<uint16> Remap);
+
+    // Сохранение/загрузка как есть (палитра + упакованные слова).
+    // При загрузке повреждённых данных архив помечается ошибкой.
+    friend FArchive& operator<<(FArchive& Ar, FVoxelPaletteStorage& Storage);
+
+private:
+    TArray<uint16> Palette;
+    TArray<uint64> Data;
+    int32 NumEntries = 0;
+    int32 BitsPerEntry = 0;
+
+    // При 0 бит смещение и маска нулевые — читается Data[0] == 0, без ветвления
+    FORCEINLINE uint32 GetPaletteIndex(int32 Index) const
+    {
+        const int32 BitOffset = Index * BitsPerEntry;
+        const uint64 Mask = (1ull << BitsPerEntry) - 1;
+        return (uint32)((Data[BitOffset >> 6] >> (BitOffset & 63)) & Mask);
+    }
+
+    void SetPaletteIndex(int32 Index, uint32 PaletteIndex);
+    int32 FindOrAddPaletteIndex(uint16 Value);
+
+    // Перепаковать данные с новой разрядностью
+    void Repack(int32 NewBitsPerEntry);
+
+    static int32 NumWordsFor(int32 InNumEntries, int32 InBitsPerEntry)
+    {
+        return FMath::Max(1, (InNumEntries * InBitsPerEntry + 63) / 64);
+    }
+};
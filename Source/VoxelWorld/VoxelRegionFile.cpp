@@ -0,0 +1,393 @@
+// VoxelRegionFile.cpp
+
+#include "VoxelRegionFile.h"
+#include "VoxelTerrainGenerator.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// Верхняя граница распакованного чанка — защита от повреждённого заголовка payload'а
+static constexpr uint32 MaxRawChunkSize = 4 * 1024 * 1024;
+
+// ============================================================
+// FVoxelRegionFile
+// ============================================================
+
+FVoxelRegionFile::FVoxelRegionFile(const FString& InFilename)
+    : Filename(InFilename)
+{
+    OpenMapping();
+}
+
+FVoxelRegionFile::~FVoxelRegionFile()
+{
+    CloseMapping();
+}
+
+void FVoxelRegionFile::OpenMapping()
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    if (!PlatformFile.FileExists(*Filename)) return;
+
+    MappedFile.Reset(PlatformFile.OpenMapped(*Filename));
+    if (!MappedFile)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Voxel region: failed to map %s"), *Filename);
+        return;
+    }
+
+    MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+    if (!MappedRegion || MappedRegion->GetMappedSize() < HeaderSize)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Voxel region: %s is truncated, ignoring"), *Filename);
+        CloseMapping();
+        return;
+    }
+
+    uint32 FileHeader[2];
+    FMemory::Memcpy(FileHeader, MappedRegion->GetMappedPtr(), sizeof(FileHeader));
+    if (FileHeader[0] != Magic || FileHeader[1] != Version)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Voxel region: %s has unknown format (version %u), ignoring"), *Filename, FileHeader[1]);
+        CloseMapping();
+    }
+}
+
+void FVoxelRegionFile::CloseMapping()
+{
+    // Регион отображения должен быть освобождён раньше файла
+    MappedRegion.Reset();
+    MappedFile.Reset();
+}
+
+int64 FVoxelRegionFile::GetFileSize() const
+{
+    return MappedRegion ? MappedRegion->GetMappedSize() : 0;
+}
+
+bool FVoxelRegionFile::GetPayload(int32 LocalIndex, const uint8*& OutPayload, uint32& OutSize) const
+{
+    if (!MappedRegion || LocalIndex < 0 || LocalIndex >= VoxelRegion::ChunksPerRegion) return false;
+
+    const uint8* FileData = MappedRegion->GetMappedPtr();
+    uint32 Entry[2];
+    FMemory::Memcpy(Entry, FileData + sizeof(uint32) * 2 + LocalIndex * sizeof(Entry), sizeof(Entry));
+
+    const uint32 Offset = Entry[0];
+    const uint32 Size = Entry[1];
+    if (Size == 0 || Offset < (uint32)HeaderSize || (int64)Offset + Size > MappedRegion->GetMappedSize()) return false;
+
+    OutPayload = FileData + Offset;
+    OutSize = Size;
+    return true;
+}
+
+bool FVoxelRegionFile::HasChunk(int32 LocalIndex) const
+{
+    const uint8* Payload;
+    uint32 Size;
+    return GetPayload(LocalIndex, Payload, Size);
+}
+
+bool FVoxelRegionFile::ReadChunk(int32 LocalIndex, FVoxelChunkData& OutData) const
+{
+    const uint8* Payload;
+    uint32 Size;
+    if (!GetPayload(LocalIndex, Payload, Size)) return false;
+
+    if (!DecompressChunk(Payload, Size, OutData))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Voxel region: chunk %d in %s is corrupt, regenerating"), LocalIndex, *Filename);
+        return false;
+    }
+    return true;
+}
+
+bool FVoxelRegionFile::CompressChunk(FVoxelChunkData& Data, TArray<uint8>& OutPayload)
+{
+    TArray<uint8> Raw;
+    FMemoryWriter Writer(Raw);
+    Data.Serialize(Writer);
+    if (Writer.IsError()) return false;
+
+    int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, Raw.Num());
+    OutPayload.SetNumUninitialized(sizeof(uint32) + CompressedSize);
+
+    const uint32 RawSize = Raw.Num();
+    FMemory::Memcpy(OutPayload.GetData(), &RawSize, sizeof(uint32));
+    if (!FCompression::CompressMemory(NAME_Zlib, OutPayload.GetData() + sizeof(uint32), CompressedSize, Raw.GetData(), Raw.Num()))
+    {
+        return false;
+    }
+
+    OutPayload.SetNum(sizeof(uint32) + CompressedSize);
+    return true;
+}
+
+bool FVoxelRegionFile::DecompressChunk(const uint8* Payload, uint32 PayloadSize, FVoxelChunkData& OutData)
+{
+    if (PayloadSize <= sizeof(uint32)) return false;
+
+    uint32 RawSize;
+    FMemory::Memcpy(&RawSize, Payload, sizeof(uint32));
+    if (RawSize == 0 || RawSize > MaxRawChunkSize) return false;
+
+    TArray<uint8> Raw;
+    Raw.SetNumUninitialized(RawSize);
+    if (!FCompression::UncompressMemory(NAME_Zlib, Raw.GetData(), RawSize, Payload + sizeof(uint32), PayloadSize - sizeof(uint32)))
+    {
+        return false;
+    }
+
+    // Грузим во временный объект, чтобы повреждённые данные не испортили OutData
+    FVoxelChunkData Loaded;
+    FMemoryReader Reader(Raw);
+    Loaded.Serialize(Reader);
+    if (Reader.IsError()) return false;
+
+    OutData = MoveTemp(Loaded);
+    return true;
+}
+
+bool FVoxelRegionFile::WriteChunks(const TMap<int32, FVoxelChunkData*>& Chunks)
+{
+    // Payload'ы всех слотов: новые сжимаем, старые копируем из текущего файла
+    TArray<TArray<uint8>> Payloads;
+    Payloads.SetNum(VoxelRegion::ChunksPerRegion);
+    for (int32 LocalIndex = 0; LocalIndex < VoxelRegion::ChunksPerRegion; LocalIndex++)
+    {
+        if (FVoxelChunkData* const* Data = Chunks.Find(LocalIndex))
+        {
+            if (!CompressChunk(**Data, Payloads[LocalIndex]))
+            {
+                UE_LOG(LogTemp, Error, TEXT("Voxel region: failed to compress chunk %d for %s"), LocalIndex, *Filename);
+                return false;
+            }
+            continue;
+        }
+
+        const uint8* Payload;
+        uint32 Size;
+        if (GetPayload(LocalIndex, Payload, Size))
+        {
+            Payloads[LocalIndex].Append(Payload, Size);
+        }
+    }
+
+    TArray<uint8> FileData;
+    FMemoryWriter Writer(FileData);
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    Writer << FileMagic << FileVersion;
+
+    uint32 Offset = HeaderSize;
+    for (TArray<uint8>& Payload : Payloads)
+    {
+        uint32 EntryOffset = Payload.Num() > 0 ? Offset : 0;
+        uint32 EntrySize = Payload.Num();
+        Writer << EntryOffset << EntrySize;
+        Offset += EntrySize;
+    }
+    for (TArray<uint8>& Payload : Payloads)
+    {
+        Writer.Serialize(Payload.GetData(), Payload.Num());
+    }
+
+    // Пишем во временный файл и подменяем: отображение старого файла закрывается до замены
+    const FString TempFilename = Filename + TEXT(".tmp");
+    if (!FFileHelper::SaveArrayToFile(FileData, *TempFilename))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Voxel region: failed to write %s"), *TempFilename);
+        return false;
+    }
+
+    CloseMapping();
+    const bool bMoved = IFileManager::Get().Move(*Filename, *TempFilename, true, true);
+    if (!bMoved)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Voxel region: failed to replace %s"), *Filename);
+    }
+    OpenMapping();
+    return bMoved;
+}
+
+// ============================================================
+// FVoxelRegionStorage
+// ============================================================
+
+FVoxelRegionStorage::FVoxelRegionStorage(const FString& InDirectory)
+    : Directory(InDirectory)
+{
+}
+
+FVoxelRegionFile& FVoxelRegionStorage::GetRegion(const FIntPoint& RegionCoords)
+{
+    if (TUniquePtr<FVoxelRegionFile>* Existing = Regions.Find(RegionCoords))
+    {
+        return **Existing;
+    }
+
+    const FString Filename = Directory / FString::Printf(TEXT("r.%d.%d.vxr"), RegionCoords.X, RegionCoords.Y);
+    return *Regions.Add(RegionCoords, MakeUnique<FVoxelRegionFile>(Filename));
+}
+
+bool FVoxelRegionStorage::LoadChunk(const FIntPoint& ChunkCoords, FVoxelChunkData& OutData)
+{
+    FVoxelRegionFile& Region = GetRegion(FVoxelRegionFile::GetRegionCoords(ChunkCoords));
+    return Region.ReadChunk(FVoxelRegionFile::GetLocalIndex(ChunkCoords), OutData);
+}
+
+int32 FVoxelRegionStorage::SaveChunks(const TArray<TPair<FIntPoint, FVoxelChunkData*>>& Chunks)
+{
+    if (Chunks.Num() == 0) return 0;
+
+    TMap<FIntPoint, TMap<int32, FVoxelChunkData*>> ChunksByRegion;
+    for (const TPair<FIntPoint, FVoxelChunkData*>& Chunk : Chunks)
+    {
+        ChunksByRegion.FindOrAdd(FVoxelRegionFile::GetRegionCoords(Chunk.Key))
+                      .Add(FVoxelRegionFile::GetLocalIndex(Chunk.Key), Chunk.Value);
+    }
+
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    int32 NumSaved = 0;
+    for (const auto& Pair : ChunksByRegion)
+    {
+        if (!GetRegion(Pair.Key).WriteChunks(Pair.Value)) continue;
+
+        for (const auto& Chunk : Pair.Value)
+        {
+            Chunk.Value->bNeedsSave = false;
+        }
+        NumSaved += Pair.Value.Num();
+    }
+    return NumSaved;
+}
+
+void FVoxelRegionStorage::Close()
+{
+    Regions.Empty();
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+// Синтетический чанк: рельеф из камня/травы/песка, несколько правок и маленьких блоков
+static void FillBenchmarkChunk(FVoxelChunkData& Data, int32 Seed)
+{
+    // Настоящие runtime ID: сохранение пишет имена блоков из UVoxelDatabase
+    FVoxelTerrainGenerator Terrain;
+    Terrain.ResolveBlockIDs();
+    const uint16 StoneID = Terrain.StoneID, GrassID = Terrain.GrassID, SandID = Terrain.SandID, SmallID = Terrain.StoneID;
+
+    for (int32 Y = 0; Y < VoxelConstants::ChunkSizeY; Y++)
+    {
+        for (int32 X = 0; X < VoxelConstants::ChunkSizeX; X++)
+        {
+            const int32 Height = 6 + (X * 7 + Y * 13 + Seed * 5) % 12;
+            for (int32 Z = 0; Z < Height; Z++)
+            {
+                Data.SetBlock(X, Y, Z, Z < Height - 3 ? StoneID : (Height < 8 ? SandID : GrassID));
+            }
+        }
+    }
+    for (FVoxelPaletteStorage& Section : Data.Sections)
+    {
+        Section.Compact();
+    }
+
+    for (int32 i = 0; i < 8; i++)
+    {
+        const int32 X = (Seed * 3 + i * 5) % VoxelConstants::ChunkSizeX;
+        const int32 Y = (Seed * 7 + i * 3) % VoxelConstants::ChunkSizeY;
+        Data.EditBlock(X, Y, 20 + i, StoneID);
+        Data.SmallBlocks.Add(FVoxelChunkData::GetBlockIndex(Y, X, 24), (Seed + i * 9) % 64, SmallID);
+    }
+}
+
+static TArray<uint8> SerializeForCompare(FVoxelChunkData& Data)
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    Data.Serialize(Writer);
+    return Bytes;
+}
+
+FVoxelRegionBenchmarkResult FVoxelRegionStorage::RunBenchmark(int32 NumChunks)
+{
+    FVoxelRegionBenchmarkResult Result;
+    NumChunks = FMath::Max(NumChunks, 1);
+    Result.NumChunks = NumChunks;
+    const FString BenchmarkDir = FPaths::ProjectSavedDir() / TEXT("VoxelWorld") / TEXT("RegionBenchmark");
+    IFileManager::Get().DeleteDirectory(*BenchmarkDir, false, true);
+
+    // Несколько шаблонов на все чанки — генерация не должна мерить сама себя
+    constexpr int32 NumTemplates = 16;
+    TArray<FVoxelChunkData> Templates;
+    Templates.SetNum(NumTemplates);
+    TArray<TArray<uint8>> TemplateBytes;
+    for (int32 i = 0; i < NumTemplates; i++)
+    {
+        FillBenchmarkChunk(Templates[i], i);
+        TemplateBytes.Add(SerializeForCompare(Templates[i]));
+    }
+
+    const int32 Side = FMath::CeilToInt(FMath::Sqrt((float)NumChunks));
+    TArray<TPair<FIntPoint, FVoxelChunkData*>> Chunks;
+    Chunks.Reserve(NumChunks);
+    for (int32 i = 0; i < NumChunks; i++)
+    {
+        Chunks.Emplace(FIntPoint(i % Side, i / Side), &Templates[i % NumTemplates]);
+        Result.RawBytes += TemplateBytes[i % NumTemplates].Num();
+    }
+
+    {
+        FVoxelRegionStorage Storage(BenchmarkDir);
+        const double Start = FPlatformTime::Seconds();
+        Result.NumSaved = Storage.SaveChunks(Chunks);
+        Result.WriteSeconds = FPlatformTime::Seconds() - Start;
+
+        for (const auto& Pair : Storage.Regions)
+        {
+            Result.DiskBytes += Pair.Value->GetFileSize();
+        }
+        if (Result.NumSaved != NumChunks)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Voxel region benchmark: saved %d of %d chunks"), Result.NumSaved, NumChunks);
+        }
+    }
+
+    {
+        // Новое хранилище — отображения открываются заново, как при следующем запуске
+        FVoxelRegionStorage Storage(BenchmarkDir);
+        FVoxelChunkData Loaded;
+        for (int32 i = 0; i < NumChunks; i++)
+        {
+            const double Start = FPlatformTime::Seconds();
+            const bool bLoaded = Storage.LoadChunk(Chunks[i].Key, Loaded);
+            Result.ReadSeconds += FPlatformTime::Seconds() - Start;
+
+            if (!bLoaded || SerializeForCompare(Loaded) != TemplateBytes[i % NumTemplates])
+            {
+                Result.NumMismatches++;
+            }
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*BenchmarkDir, false, true);
+
+    UE_LOG(LogTemp, Log, TEXT("Voxel region benchmark: %d chunks, %.2f MB raw -> %.2f MB on disk (%.1fx)"),
+           NumChunks, Result.RawBytes / (1024.0 * 1024.0), Result.DiskBytes / (1024.0 * 1024.0),
+           Result.DiskBytes > 0 ? (double)Result.RawBytes / Result.DiskBytes : 0.0);
+    UE_LOG(LogTemp, Log, TEXT("Voxel region benchmark: write %.3f s (%.1f MB/s), read %.3f s (%.1f MB/s, %.1f us/chunk), %d mismatches"),
+           Result.WriteSeconds, Result.GetWriteMBPerSecond(),
+           Result.ReadSeconds, Result.GetReadMBPerSecond(),
+           Result.ReadSeconds * 1e6 / NumChunks, Result.NumMismatches);
+    return Result;
+}
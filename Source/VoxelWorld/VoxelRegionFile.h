@@ -0,0 +1,115 @@
+// VoxelRegionFile.h
+// Сохранение чанков на диск: регион 32x32 чанка в одном файле, чтение через memory-mapped I/O
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelChunkData.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace VoxelRegion
+{
+    constexpr int32 RegionSize = 32;
+    constexpr int32 ChunksPerRegion = RegionSize * RegionSize;
+}
+
+// Формат файла региона:
+//   [uint32 Magic][uint32 Version]
+//   [ChunksPerRegion x { uint32 Offset, uint32 Size }]   Size == 0 — чанка в файле нет
+//   payload чанка: [uint32 RawSize][zlib( FVoxelChunkData::Serialize )]
+// Payload'ы распаковываются прямо из отображённой в память страницы файла.
+// Версия 2: палитры чанка ссылаются на его таблицу имён блоков. Файлы версии 1 хранили
+// runtime ID, которые не переживают изменения базы блоков, и не читаются.
+class VOXELWORLD_API FVoxelRegionFile
+{
+public:
+    static constexpr uint32 Magic = 0x47525856; // 'VXRG'
+    static constexpr uint32 Version = 2;
+    static constexpr int32 HeaderSize = sizeof(uint32) * 2 + VoxelRegion::ChunksPerRegion * sizeof(uint32) * 2;
+
+    static FIntPoint GetRegionCoords(const FIntPoint& ChunkCoords)
+    {
+        return FIntPoint(FMath::DivideAndRoundDown(ChunkCoords.X, VoxelRegion::RegionSize),
+                         FMath::DivideAndRoundDown(ChunkCoords.Y, VoxelRegion::RegionSize));
+    }
+    static int32 GetLocalIndex(const FIntPoint& ChunkCoords)
+    {
+        const FIntPoint Region = GetRegionCoords(ChunkCoords);
+        return (ChunkCoords.X - Region.X * VoxelRegion::RegionSize) +
+               (ChunkCoords.Y - Region.Y * VoxelRegion::RegionSize) * VoxelRegion::RegionSize;
+    }
+
+    explicit FVoxelRegionFile(const FString& InFilename);
+    ~FVoxelRegionFile();
+
+    bool HasChunk(int32 LocalIndex) const;
+
+    // Распаковать и загрузить чанк; false — чанка нет или данные повреждены
+    bool ReadChunk(int32 LocalIndex, FVoxelChunkData& OutData) const;
+
+    // Переписать файл: заданные чанки — новые данные, остальные копируются как есть
+    bool WriteChunks(const TMap<int32, FVoxelChunkData*>& Chunks);
+
+    int64 GetFileSize() const;
+
+    // Payload чанка: сжатый FVoxelChunkData::Serialize с размером впереди
+    static bool CompressChunk(FVoxelChunkData& Data, TArray<uint8>& OutPayload);
+    static bool DecompressChunk(const uint8* Payload, uint32 PayloadSize, FVoxelChunkData& OutData);
+
+private:
+    FString Filename;
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    void OpenMapping();
+    void CloseMapping();
+
+    // Указатель на payload чанка внутри отображения
+    bool GetPayload(int32 LocalIndex, const uint8*& OutPayload, uint32& OutSize) const;
+};
+
+// Итог Voxel.RegionBenchmark / теста VoxelWorld.Region.RoundTrip
+struct FVoxelRegionBenchmarkResult
+{
+    int32 NumChunks = 0;
+    int32 NumSaved = 0;
+    // Чанки, которые не загрузились или загрузились не байт в байт
+    int32 NumMismatches = 0;
+    int64 RawBytes = 0;
+    int64 DiskBytes = 0;
+    double WriteSeconds = 0.0;
+    double ReadSeconds = 0.0;
+
+    double GetWriteMBPerSecond() const { return WriteSeconds > 0.0 ? RawBytes / (1024.0 * 1024.0) / WriteSeconds : 0.0; }
+    double GetReadMBPerSecond() const { return ReadSeconds > 0.0 ? RawBytes / (1024.0 * 1024.0) / ReadSeconds : 0.0; }
+};
+
+// Все регионы одного сохранения мира. Открытые файлы кэшируются по координатам региона.
+class VOXELWORLD_API FVoxelRegionStorage
+{
+public:
+    explicit FVoxelRegionStorage(const FString& InDirectory);
+
+    bool LoadChunk(const FIntPoint& ChunkCoords, FVoxelChunkData& OutData);
+
+    // Сохранить чанки; каждый затронутый регион переписывается один раз.
+    // У записанных чанков сбрасывается bNeedsSave. Возвращает число записанных чанков.
+    int32 SaveChunks(const TArray<TPair<FIntPoint, FVoxelChunkData*>>& Chunks);
+
+    // Закрыть все отображения файлов
+    void Close();
+
+    const FString& GetDirectory() const { return Directory; }
+
+    // Запись и чтение NumChunks синтетических чанков во временный каталог, результат в лог.
+    // Только game thread (сериализация чанка обращается к UVoxelDatabase).
+    static FVoxelRegionBenchmarkResult RunBenchmark(int32 NumChunks);
+
+private:
+    FString Directory;
+    TMap<FIntPoint, TUniquePtr<FVoxelRegionFile>> Regions;
+
+    FVoxelRegionFile& GetRegion(const FIntPoint& RegionCoords);
+};
@@ -0,0 +1,161 @@
+// VoxelSmallBlockStorage.cpp
+
+#include "VoxelSmallBlockStorage.h"
+
+int32 FVoxelSmallBlockStorage::FindOrAddPaletteIndex(uint16 RuntimeID)
+{
+    int32 FreeIndex = INDEX_NONE;
+    for (int32 Index = 0; Index < Palette.Num(); Index++)
+    {
+        if (PaletteRefCounts[Index] == 0)
+        {
+            if (FreeIndex == INDEX_NONE) FreeIndex = Index;
+        }
+        else if (Palette[Index] == RuntimeID)
+        {
+            return Index;
+        }
+    }
+
+    if (FreeIndex != INDEX_NONE)
+    {
+        Palette[FreeIndex] = RuntimeID;
+        return FreeIndex;
+    }
+    if (Palette.Num() >= MaxPaletteSize)
+    {
+        return INDEX_NONE;
+    }
+    PaletteRefCounts.Add(0);
+    return Palette.Add(RuntimeID);
+}
+
+void FVoxelSmallBlockStorage::ReleasePaletteIndex(int32 PaletteIndex)
+{
+    if (--PaletteRefCounts[PaletteIndex] > 0) return;
+
+    // Свободная запись хранит 0; хвост из свободных записей отрезается
+    Palette[PaletteIndex] = 0;
+    while (Palette.Num() > 0 && PaletteRefCounts.Last() == 0)
+    {
+        Palette.Pop(EAllowShrinking::No);
+        PaletteRefCounts.Pop(EAllowShrinking::No);
+    }
+}
+
+bool FVoxelSmallBlockStorage::Add(int32 CellIndex, int32 Bit, uint16 RuntimeID)
+{
+    // Сначала занятость: неудачная попытка не должна тратить запись палитры
+    const uint64 BitMask = 1ull << Bit;
+    if (GetCellMask(CellIndex) & BitMask) return false;
+
+    const int32 PaletteIndex = FindOrAddPaletteIndex(RuntimeID);
+    if (PaletteIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Small block palette is full (%d types), block not placed"), Palette.Num());
+        return false;
+    }
+    PaletteRefCounts[PaletteIndex]++;
+
+    FVoxelSmallBlockCell& Cell = Cells.FindOrAdd(CellIndex);
+    Cell.PaletteIndices.Insert((uint8)PaletteIndex, Cell.GetRank(Bit));
+    Cell.Occupancy |= BitMask;
+    NumBlocks++;
+    return true;
+}
+
+bool FVoxelSmallBlockStorage::Remove(int32 CellIndex, int32 Bit)
+{
+    FVoxelSmallBlockCell* Cell = Cells.Find(CellIndex);
+    const uint64 BitMask = 1ull << Bit;
+    if (!Cell || !(Cell->Occupancy & BitMask)) return false;
+
+    const int32 Rank = Cell->GetRank(Bit);
+    ReleasePaletteIndex(Cell->PaletteIndices[Rank]);
+    Cell->PaletteIndices.RemoveAt(Rank);
+    Cell->Occupancy &= ~BitMask;
+    NumBlocks--;
+
+    if (Cell->Occupancy == 0)
+    {
+        Cells.Remove(CellIndex);
+    }
+    return true;
+}
+
+uint16 FVoxelSmallBlockStorage::Get(int32 CellIndex, int32 Bit) const
+{
+    const FVoxelSmallBlockCell* Cell = Cells.Find(CellIndex);
+    if (!Cell || !((Cell->Occupancy >> Bit) & 1ull)) return 0;
+
+    return Palette[Cell->PaletteIndices[Cell->GetRank(Bit)]];
+}
+
+void FVoxelSmallBlockStorage::Empty()
+{
+    Cells.Empty();
+    Palette.Empty();
+    PaletteRefCounts.Empty();
+    NumBlocks = 0;
+}
+
+FArchive& operator<<(FArchive& Ar, FVoxelSmallBlockStorage& Storage)
+{
+    Ar << Storage.Palette;
+    Ar << Storage.Cells;
+
+    if (Ar.IsLoading())
+    {
+        // Число блоков и ссылки на записи палитры не хранятся — считаются по ячейкам
+        bool bValid = !Ar.IsError() && Storage.Palette.Num() <= FVoxelSmallBlockStorage::MaxPaletteSize;
+        Storage.PaletteRefCounts.Init(0, Storage.Palette.Num());
+        Storage.NumBlocks = 0;
+        for (const auto& Pair : Storage.Cells)
+        {
+            if (!bValid) break;
+            const FVoxelSmallBlockCell& Cell = Pair.Value;
+            bValid = Cell.Occupancy != 0 && Cell.PaletteIndices.Num() == FMath::CountBits(Cell.Occupancy);
+            for (uint8 PaletteIndex : Cell.PaletteIndices)
+            {
+                if (PaletteIndex >= Storage.Palette.Num())
+                {
+                    bValid = false;
+                    break;
+                }
+                Storage.PaletteRefCounts[PaletteIndex]++;
+            }
+            Storage.NumBlocks += Cell.PaletteIndices.Num();
+        }
+
+        if (!bValid)
+        {
+            Ar.SetError();
+            Storage.Empty();
+        }
+    }
+    return Ar;
+}
+
+bool FVoxelSmallBlockStorage::RemapValues(TConstArrayView<uint16> Remap)
+{
+    for (int32 Index = 0; Index < Palette.Num(); Index++)
+    {
+        const uint16 Value = Palette[Index];
+        if (PaletteRefCounts[Index] > 0 && (Value >= Remap.Num() || Remap[Value] == MAX_uint16)) return false;
+    }
+    for (int32 Index = 0; Index < Palette.Num(); Index++)
+    {
+        if (PaletteRefCounts[Index] > 0) Palette[Index] = Remap[Palette[Index]];
+    }
+    return true;
+}
+
+SIZE_T FVoxelSmallBlockStorage::GetAllocatedSize() const
+{
+    SIZE_T Size = Cells.GetAllocatedSize() + Palette.GetAllocatedSize() + PaletteRefCounts.GetAllocatedSize();
+    for (const auto& Pair : Cells)
+    {
+        Size += Pair.Value.PaletteIndices.GetAllocatedSize();
+    }
+    return Size;
+}
@@ -0,0 +1,106 @@
+// VoxelSmallBlockStorage.h
+// Хранилище маленьких блоков: 64-битная маска заполненности на каждую большую ячейку
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Большая ячейка = 4x4x4 маленьких блока = ровно 64 бита.
+// Бит маленького блока: SX + SY * 4 + SZ * 16 (SX/SY/SZ — позиция внутри ячейки).
+struct FVoxelSmallBlockCell
+{
+    uint64 Occupancy = 0;
+
+    // Индексы в палитру хранилища, по одному на установленный бит,
+    // в порядке возрастания номера бита
+    TArray<uint8> PaletteIndices;
+
+    // Позиция данных бита в PaletteIndices — число установленных битов младше него
+    FORCEINLINE int32 GetRank(int32 Bit) const
+    {
+        return FMath::CountBits(Occupancy & ((1ull << Bit) - 1));
+    }
+
+    friend FArchive& operator<<(FArchive& Ar, FVoxelSmallBlockCell& Cell)
+    {
+        return Ar << Cell.Occupancy << Cell.PaletteIndices;
+    }
+};
+
+// Маленькие блоки чанка. Ключ ячейки — индекс большого блока (как в палитре больших блоков),
+// runtime ID хранятся один раз в общей палитре, на блок остаётся бит маски + байт индекса.
+// Запись палитры без блоков освобождается и занимается следующим новым типом.
+class VOXELWORLD_API FVoxelSmallBlockStorage
+{
+public:
+    static constexpr int32 CellSize = 4;
+    static constexpr int32 MaxPaletteSize = 256;
+
+    static FORCEINLINE int32 GetBitIndex(int32 SX, int32 SY, int32 SZ)
+    {
+        return SX + SY * CellSize + SZ * CellSize * CellSize;
+    }
+
+    // false — позиция занята или палитра переполнена
+    bool Add(int32 CellIndex, int32 Bit, uint16 RuntimeID);
+    bool Remove(int32 CellIndex, int32 Bit);
+
+    FORCEINLINE bool Has(int32 CellIndex, int32 Bit) const
+    {
+        return (GetCellMask(CellIndex) >> Bit) & 1ull;
+    }
+
+    // Runtime ID маленького блока, 0 — нет блока
+    uint16 Get(int32 CellIndex, int32 Bit) const;
+
+    FORCEINLINE uint64 GetCellMask(int32 CellIndex) const
+    {
+        const FVoxelSmallBlockCell* Cell = Cells.Find(CellIndex);
+        return Cell ? Cell->Occupancy : 0;
+    }
+
+    FORCEINLINE uint16 GetPaletteValue(uint8 PaletteIndex) const { return Palette[PaletteIndex]; }
+
+    int32 Num() const { return NumBlocks; }
+    bool IsEmpty() const { return NumBlocks == 0; }
+    void Empty();
+
+    SIZE_T GetAllocatedSize() const;
+
+    // Func(uint16 RuntimeID) для каждой занятой записи палитры
+    template <typename FuncType>
+    void ForEachPaletteValue(FuncType&& Func) const
+    {
+        for (int32 Index = 0; Index < Palette.Num(); Index++)
+        {
+            if (PaletteRefCounts[Index] > 0) Func(Palette[Index]);
+        }
+    }
+
+    // Как FVoxelPaletteStorage::RemapValues, только для занятых записей
+    bool RemapValues(TConstArrayView<uint16> Remap);
+
+    // При загрузке повреждённых данных архив помечается ошибкой
+    friend FArchive& operator<<(FArchive& Ar, FVoxelSmallBlockStorage& Storage);
+
+    // Func(int32 CellIndex, const FVoxelSmallBlockCell& Cell)
+    template <typename FuncType>
+    void ForEachCell(FuncType&& Func) const
+    {
+        for (const auto& Pair : Cells)
+        {
+            Func(Pair.Key, Pair.Value);
+        }
+    }
+
+private:
+    TMap<int32, FVoxelSmallBlockCell> Cells;
+    TArray<uint16> Palette;
+    // Число блоков на запись палитры; 0 — запись свободна. Не сохраняется, пересчитывается при загрузке.
+    TArray<int32> PaletteRefCounts;
+    int32 NumBlocks = 0;
+
+    // Запись палитры под RuntimeID: существующая, свободная или новая; INDEX_NONE — палитра полна
+    int32 FindOrAddPaletteIndex(uint16 RuntimeID);
+    void ReleasePaletteIndex(int32 PaletteIndex);
+};
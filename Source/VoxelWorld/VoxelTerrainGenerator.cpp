@@ -0,0 +1,94 @@
+// VoxelTerrainGenerator.cpp
+
+#include "VoxelTerrainGenerator.h"
+#include "VoxelDatabase.h"
+#include "VoxelHeightmapCache.h"
+
+void FVoxelTerrainGenerator::ResolveBlockIDs()
+{
+    UVoxelDatabase* DB = UVoxelDatabase::Get();
+    
+    FName StoneName = "StoneL";
+    FName GrassName = "GrassL";
+    FName SandName = "SandL";
+    
+    if (DB)
+    {
+        if (!DB->GetBlockData(StoneName)) StoneName = "Stone";
+        if (!DB->GetBlockData(GrassName)) GrassName = "Grass";
+        if (!DB->GetBlockData(SandName)) SandName = "Sand";
+        
+        StoneID = DB->GetOrAddRuntimeID(StoneName);
+        GrassID = DB->GetOrAddRuntimeID(GrassName);
+        SandID = DB->GetOrAddRuntimeID(SandName);
+    }
+    else
+    {
+        StoneID = GrassID = SandID = FVoxelBlockTables::AirID;
+    }
+}
+
+void FVoxelTerrainGenerator::GenerateBlocks(const FIntPoint& ChunkCoords, FVoxelHeightmapCache& HeightmapCache, FVoxelChunkData& OutData) const
+{
+    constexpr int32 SX = VoxelConstants::ChunkSizeX;
+    constexpr int32 SY = VoxelConstants::ChunkSizeY;
+    
+    const FVoxelHeightTilePtr HeightTile = HeightmapCache.GetTile(ChunkCoords);
+    
+    // Высота поверхности каждого столбца; маска столбца известна сразу — блоки ниже высоты
+    int32 SurfaceHeights[SX * SY];
+    int32 MinSurface = VoxelConstants::ChunkSizeZ;
+    int32 MaxSurface = 0;
+    
+    for (int32 X = 0; X < SX; X++)
+    {
+        for (int32 Y = 0; Y < SY; Y++)
+        {
+            const int32 MaxHeight = HeightTile->SurfaceHeights[FVoxelChunkData::GetColumnIndex(X, Y)];
+
+            SurfaceHeights[FVoxelChunkData::GetColumnIndex(X, Y)] = MaxHeight;
+            OutData.ColumnSolidMasks[FVoxelChunkData::GetColumnIndex(X, Y)] = (1u << MaxHeight) - 1;
+            MinSurface = FMath::Min(MinSurface, MaxHeight);
+            MaxSurface = FMath::Max(MaxSurface, MaxHeight);
+        }
+    }
+    
+    for (int32 SectionIndex = 0; SectionIndex < VoxelConstants::NumSectionsZ; SectionIndex++)
+    {
+        FVoxelPaletteStorage& Section = OutData.Sections[SectionIndex];
+        const int32 ZStart = SectionIndex * VoxelConstants::SectionSizeZ;
+        const int32 ZEnd = ZStart + VoxelConstants::SectionSizeZ;
+        
+        // Целиком над поверхностью — однородный воздух
+        if (ZStart >= MaxSurface)
+        {
+            Section.Init(VoxelConstants::SectionVolume, FVoxelBlockTables::AirID);
+            continue;
+        }
+        // Целиком под слоем травы/песка — однородный камень
+        if (ZEnd <= MinSurface - 3)
+        {
+            Section.Init(VoxelConstants::SectionVolume, StoneID);
+            continue;
+        }
+        
+        Section.Init(VoxelConstants::SectionVolume, FVoxelBlockTables::AirID);
+        for (int32 Z = ZStart; Z < ZEnd; Z++)
+        {
+            for (int32 Y = 0; Y < SY; Y++)
+            {
+                for (int32 X = 0; X < SX; X++)
+                {
+                    const int32 MaxHeight = SurfaceHeights[FVoxelChunkData::GetColumnIndex(X, Y)];
+                    if (Z >= MaxHeight) continue;
+                    
+                    Section.Set(FVoxelChunkData::GetBlockIndex(X, Y, Z) - SectionIndex * VoxelConstants::SectionVolume,
+                                GetTerrainBlock(Z, MaxHeight));
+                }
+            }
+        }
+        
+        // Секция могла оказаться однородной (например, весь камень при неровном MinSurface)
+        Section.Compact();
+    }
+}
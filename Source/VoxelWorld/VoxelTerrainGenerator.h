@@ -0,0 +1,31 @@
+// VoxelTerrainGenerator.h
+// Процедурный рельеф: заполнение блоков чанка по кэшу высот. Без UObject — можно вызывать из рабочих потоков.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelChunkData.h"
+
+class FVoxelHeightmapCache;
+
+struct VOXELWORLD_API FVoxelTerrainGenerator
+{
+    // Runtime ID блоков террейна (L-версии из Data Assets или дефолтные)
+    uint16 StoneID = 0;
+    uint16 GrassID = 0;
+    uint16 SandID = 0;
+
+    // Разрешить ID через UVoxelDatabase — только в игровом потоке
+    void ResolveBlockIDs();
+
+    // Заполнить пустой чанк из шума (без отметок в дельте правок)
+    void GenerateBlocks(const FIntPoint& ChunkCoords, FVoxelHeightmapCache& HeightmapCache, FVoxelChunkData& OutData) const;
+
+    // Блок рельефа на высоте Z в столбце с поверхностью SurfaceHeight (воздух выше поверхности)
+    uint16 GetTerrainBlock(int32 Z, int32 SurfaceHeight) const
+    {
+        if (Z >= SurfaceHeight) return 0; // FVoxelBlockTables::AirID
+        if (Z < SurfaceHeight - 3) return StoneID;
+        return SurfaceHeight < 6 ? SandID : GrassID;
+    }
+};
@@ -12,8 +12,9 @@ public class VoxelWorld : ModuleRules
 			"Engine", 
 			"InputCore",
 			"EnhancedInput",
-			"ProceduralMeshComponent",
-			"RenderCore"
+			"PhysicsCore",
+			"RenderCore",
+			"RHI"
 		});
 
 		PrivateDependencyModuleNames.AddRange(new string[] { });
@@ -3,10 +3,83 @@
 #include "VoxelWorldManager.h"
 #include "VoxelChunk.h"
 #include "VoxelDatabase.h"
+#include "VoxelDensitySmoothing.h"
+#include "VoxelNoise.h"
+#include "VoxelPackedMesh.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
 
 AVoxelWorldManager* AVoxelWorldManager::Instance = nullptr;
 
+static FAutoConsoleCommand GVoxelMemoryStatsCommand(
+    TEXT("Voxel.MemoryStats"),
+    TEXT("Logs voxel storage memory of loaded chunks compared to the flat FName layout"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        if (AVoxelWorldManager* WM = AVoxelWorldManager::GetInstance())
+        {
+            WM->LogMemoryStats();
+        }
+    }));
+
+static FAutoConsoleCommand GVoxelMeshStatsCommand(
+    TEXT("Voxel.MeshStats"),
+    TEXT("Logs vertex/triangle counts of loaded chunks and the reduction from greedy meshing"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        if (AVoxelWorldManager* WM = AVoxelWorldManager::GetInstance())
+        {
+            WM->LogMeshStats();
+        }
+    }));
+
+static FAutoConsoleCommand GVoxelSaveCommand(
+    TEXT("Voxel.Save"),
+    TEXT("Writes all chunks with unsaved edits to the world's region files"),
+    FConsoleCommandDelegate::CreateLambda([]()
+    {
+        if (AVoxelWorldManager* WM = AVoxelWorldManager::GetInstance())
+        {
+            WM->SaveWorld();
+        }
+    }));
+
+static FAutoConsoleCommand GVoxelRegionBenchmarkCommand(
+    TEXT("Voxel.RegionBenchmark"),
+    TEXT("Voxel.RegionBenchmark [NumChunks=10000]: round-trips synthetic chunks through region files and logs MB/s"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 NumChunks = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+        FVoxelRegionStorage::RunBenchmark(NumChunks);
+    }));
+
+static FAutoConsoleCommand GVoxelNoiseBenchmarkCommand(
+    TEXT("Voxel.NoiseBenchmark"),
+    TEXT("Voxel.NoiseBenchmark [NumTiles=4096]: compares scalar and batched FBM heightmap tiles and logs the max error"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 NumTiles = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 4096;
+        FVoxelNoise::RunBenchmark(NumTiles);
+    }));
+
+static FAutoConsoleCommand GVoxelSmoothBenchmarkCommand(
+    TEXT("Voxel.SmoothBenchmark"),
+    TEXT("Voxel.SmoothBenchmark [NumChunks=256]: compares the reference and separable density smoothing for 1..3 passes and logs the max error"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 NumChunks = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 256;
+        FVoxelDensitySmoothing::RunBenchmark(NumChunks);
+    }));
+
+static FAutoConsoleCommand GVoxelPackedMeshTestCommand(
+    TEXT("Voxel.PackedMeshTest"),
+    TEXT("Voxel.PackedMeshTest [NumVertices=65536]: packs synthetic chunk vertices, logs bytes per vertex and the max decode error"),
+    FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+    {
+        const int32 NumVertices = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 65536;
+        FVoxelPackedMesh::RunSelfTest(NumVertices);
+    }));
+
 AVoxelWorldManager::AVoxelWorldManager()
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -21,6 +94,32 @@ void AVoxelWorldManager::BeginPlay()
     UVoxelDatabase::Get();
     
     Instance = this;
+    if (bSaveWorld)
+    {
+        RegionStorage = MakeUnique<FVoxelRegionStorage>(FPaths::ProjectSavedDir() / TEXT("VoxelWorld") / WorldSaveName);
+    }
+    ChunkStore.SetBudgetBytes((SIZE_T)ChunkDataBudgetMB * 1024 * 1024);
+    HeightmapCache->SetMaxTiles(HeightmapCacheTiles);
+    
+    // Заранее созданные акторы: первые кадры стриминга обходятся без спавна.
+    // Сначала все спавнятся и только потом уходят в пул — иначе AcquireChunkActor
+    // брал бы из пула тот же актор и пул вырос бы до одного.
+    TArray<AVoxelChunk*> PrewarmedChunks;
+    PrewarmedChunks.Reserve(ChunkPoolPrewarm);
+    for (int32 i = 0; i < ChunkPoolPrewarm; i++)
+    {
+        if (AVoxelChunk* Chunk = AcquireChunkActor())
+        {
+            PrewarmedChunks.Add(Chunk);
+        }
+    }
+    ChunkPool.Reserve(ChunkPool.Num() + PrewarmedChunks.Num());
+    for (AVoxelChunk* Chunk : PrewarmedChunks)
+    {
+        ReleaseChunkActor(Chunk);
+    }
+    NumChunkActorsReused = 0;
+    
     PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
     
     if (PlayerPawn)
@@ -32,6 +131,11 @@ void AVoxelWorldManager::BeginPlay()
 void AVoxelWorldManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
     Super::EndPlay(EndPlayReason);
+    SaveWorld();
+    ChunkPool.Empty();
+    ChunkStore.Empty();
+    HeightmapCache->Empty();
+    RegionStorage.Reset();
     if (Instance == this) Instance = nullptr;
 }
 
@@ -52,6 +156,17 @@ void AVoxelWorldManager::Tick(float DeltaTime)
         UpdateChunks();
         LastPlayerChunk = CurrentChunk;
     }
+    
+    ProcessDirtyChunks();
+    ProcessChunkQueue();
+    
+    // Чанки с правками, которые хранилище не смогло вытеснить, пишутся пачкой не чаще раза в EvictedSaveInterval:
+    // запись в UnloadChunk переписывала бы файл региона на каждый выгруженный чанк
+    if (RegionStorage && ChunkStore.GetNumUnsavedReleased() > 0 && ChunkStore.IsOverBudget() &&
+        GetWorld()->GetTimeSeconds() >= NextEvictedSaveTime)
+    {
+        SaveEvictedChunks();
+    }
 }
 
 FIntVector2 AVoxelWorldManager::WorldToChunkCoords(const FVector& WorldPosition) const
@@ -111,33 +226,237 @@ void AVoxelWorldManager::UpdateChunks()
     for (const FIntPoint& Coord : ChunksToUnload)
         UnloadChunk(Coord.X, Coord.Y);
     
+    // Кольца LOD сдвинулись вместе с игроком: перестраиваются только чанки, чей LOD изменился
+    for (auto& Pair : ActiveChunks)
+    {
+        if (Pair.Value) UpdateChunkLOD(Pair.Value, Pair.Key, PlayerChunk);
+    }
+    
+    // Недостающие чанки не грузим сразу (при старте это весь квадрат радиуса за один кадр),
+    // а ставим в очередь — её разбирает ProcessChunkQueue по приоритету и бюджету кадра
+    PendingLoads.Reset();
     for (int32 X = PlayerChunk.X - VoxelConstants::RenderDistance; X <= PlayerChunk.X + VoxelConstants::RenderDistance; X++)
     {
         for (int32 Y = PlayerChunk.Y - VoxelConstants::RenderDistance; Y <= PlayerChunk.Y + VoxelConstants::RenderDistance; Y++)
         {
             if (!ActiveChunks.Contains(FIntPoint(X, Y)))
-                LoadChunk(X, Y);
+                PendingLoads.Add(FIntPoint(X, Y));
         }
     }
 }
 
-void AVoxelWorldManager::LoadChunk(int32 ChunkX, int32 ChunkY)
+void AVoxelWorldManager::ProcessDirtyChunks()
 {
-    FVector SpawnLocation(
-        ChunkX * VoxelConstants::ChunkSizeX * VoxelConstants::BlockSize,
-        ChunkY * VoxelConstants::ChunkSizeY * VoxelConstants::BlockSize,
-        0.0f
-    );
+    for (auto It = DirtyChunks.CreateIterator(); It; ++It)
+    {
+        // Выгруженный чанк перестраивать незачем; занятый сборкой ждёт следующего кадра
+        AVoxelChunk* const* Chunk = ActiveChunks.Find(*It);
+        if (!Chunk || !*Chunk)
+        {
+            It.RemoveCurrent();
+        }
+        else if ((*Chunk)->StartPendingRebuild())
+        {
+            BuildingChunks.Add(*It);
+            It.RemoveCurrent();
+        }
+    }
+}
+
+float AVoxelWorldManager::GetChunkPriority(const FIntPoint& Coords) const
+{
+    if (!PlayerPawn) return 0.0f;
+    
+    const float ChunkWorldSizeX = VoxelConstants::ChunkSizeX * VoxelConstants::BlockSize;
+    const float ChunkWorldSizeY = VoxelConstants::ChunkSizeY * VoxelConstants::BlockSize;
+    const FVector PlayerLocation = PlayerPawn->GetActorLocation();
+    
+    // От игрока до центра чанка, в чанках
+    const FVector2D ToChunk(
+        Coords.X + 0.5f - PlayerLocation.X / ChunkWorldSizeX,
+        Coords.Y + 0.5f - PlayerLocation.Y / ChunkWorldSizeY);
+    const float Distance = ToChunk.Size();
+    
+    const FVector2D ViewDir = FVector2D(PlayerPawn->GetViewRotation().Vector()).GetSafeNormal();
+    const float Facing = Distance > KINDA_SMALL_NUMBER ? FVector2D::DotProduct(ToChunk / Distance, ViewDir) : 1.0f;
+    
+    return Distance - ViewDirectionPriority * Facing;
+}
+
+bool AVoxelWorldManager::IsChunkUrgent(const FIntPoint& Coords) const
+{
+    if (!PlayerPawn) return false;
+    
+    const FIntVector2 PlayerChunk = WorldToChunkCoords(PlayerPawn->GetActorLocation());
+    return FMath::Abs(Coords.X - PlayerChunk.X) <= 1 && FMath::Abs(Coords.Y - PlayerChunk.Y) <= 1;
+}
+
+int32 AVoxelWorldManager::GetChunkLOD(const FIntPoint& Coords, const FIntVector2& PlayerChunk) const
+{
+    if (LOD1Distance <= 0) return 0;
+    
+    const int32 Distance = FMath::Max(FMath::Abs(Coords.X - PlayerChunk.X), FMath::Abs(Coords.Y - PlayerChunk.Y));
+    if (LOD2Distance > 0 && Distance >= LOD2Distance) return 2;
+    if (Distance >= LOD1Distance) return 1;
+    return 0;
+}
+
+void AVoxelWorldManager::UpdateChunkLOD(AVoxelChunk* Chunk, const FIntPoint& Coords, const FIntVector2& PlayerChunk) const
+{
+    const int32 LODLevel = GetChunkLOD(Coords, PlayerChunk);
+    
+    // Юбки нужны с обеих сторон границы LOD: поверхности соседей расходятся вверх и вниз
+    bool bSkirts = false;
+    for (int32 Side = 0; Side < FVoxelChunkApron::NumFaceSides; Side++)
+    {
+        bSkirts |= GetChunkLOD(Coords + FVoxelChunkApron::GetSideOffset(Side), PlayerChunk) != LODLevel;
+    }
+    Chunk->SetMeshLOD(LODLevel, bSkirts);
+}
+
+void AVoxelWorldManager::ProcessChunkQueue()
+{
+    const double StartTime = FPlatformTime::Seconds();
+    const double BudgetSeconds = ChunkBuildBudgetMs / 1000.0;
+    auto IsOverBudget = [StartTime, BudgetSeconds]()
+    {
+        return FPlatformTime::Seconds() - StartTime >= BudgetSeconds;
+    };
+    auto ByPriority = [](const TPair<float, FIntPoint>& A, const TPair<float, FIntPoint>& B)
+    {
+        return A.Key < B.Key;
+    };
+    
+    // 1. Готовые фоновые сборки: выгрузка меша и коллизии, ближние первыми.
+    // Смотрим только чанки со сборкой — в кадре без правок и стриминга здесь пусто.
+    TArray<TPair<float, FIntPoint>> ReadyBuilds;
+    for (auto It = BuildingChunks.CreateIterator(); It; ++It)
+    {
+        AVoxelChunk* const* Chunk = ActiveChunks.Find(*It);
+        if (!Chunk || !*Chunk || !(*Chunk)->IsBuildInProgress())
+        {
+            It.RemoveCurrent();
+        }
+        else if ((*Chunk)->IsBuildReady())
+        {
+            ReadyBuilds.Emplace(GetChunkPriority(*It), *It);
+        }
+    }
+    ReadyBuilds.Sort(ByPriority);
+    
+    int32 NumCommitted = 0;
+    for (const TPair<float, FIntPoint>& Ready : ReadyBuilds)
+    {
+        if (!IsChunkUrgent(Ready.Value) && IsOverBudget()) break;
+        
+        AVoxelChunk* Chunk = ActiveChunks.FindChecked(Ready.Value);
+        const bool bHadBlockData = Chunk->HasBlockData();
+        Chunk->CommitPendingBuild();
+        BuildingChunks.Remove(Ready.Value);
+        if (!bHadBlockData && Chunk->HasBlockData())
+        {
+            ChunkStore.UpdateBytes(Ready.Value);
+            OnChunkBlockDataChanged(Ready.Value, true);
+        }
+        NumCommitted++;
+    }
+    
+    // 2. Спавн новых чанков по приоритету
+    if (PendingLoads.Num() == 0) return;
+    
+    TArray<TPair<float, FIntPoint>> Queue;
+    Queue.Reserve(PendingLoads.Num());
+    for (const FIntPoint& Coords : PendingLoads)
+    {
+        Queue.Emplace(GetChunkPriority(Coords), Coords);
+    }
+    Queue.Heapify(ByPriority);
+    
+    int32 NumSpawned = 0;
+    while (Queue.Num() > 0)
+    {
+        // Хотя бы один спавн за кадр, даже если бюджет ушёл на меши, — иначе очередь встанет
+        if (NumSpawned > 0 && !IsChunkUrgent(Queue.HeapTop().Value) && IsOverBudget()) break;
+        
+        TPair<float, FIntPoint> Next;
+        Queue.HeapPop(Next, ByPriority);
+        LoadChunk(Next.Value.X, Next.Value.Y);
+        NumSpawned++;
+    }
+    
+    PendingLoads.Reset();
+    for (const TPair<float, FIntPoint>& Entry : Queue)
+    {
+        PendingLoads.Add(Entry.Value);
+    }
+    
+    UE_LOG(LogTemp, VeryVerbose, TEXT("Voxel streaming: %d spawned, %d committed, %d queued, %.2f ms"),
+           NumSpawned, NumCommitted, PendingLoads.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+AVoxelChunk* AVoxelWorldManager::AcquireChunkActor()
+{
+    while (ChunkPool.Num() > 0)
+    {
+        AVoxelChunk* Chunk = ChunkPool.Pop(EAllowShrinking::No);
+        if (IsValid(Chunk))
+        {
+            NumChunkActorsReused++;
+            return Chunk;
+        }
+    }
     
     FActorSpawnParameters SpawnParams;
     SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
     
-    AVoxelChunk* NewChunk = GetWorld()->SpawnActor<AVoxelChunk>(AVoxelChunk::StaticClass(), SpawnLocation, FRotator::ZeroRotator, SpawnParams);
+    AVoxelChunk* NewChunk = GetWorld()->SpawnActor<AVoxelChunk>(AVoxelChunk::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+    if (NewChunk)
+    {
+        NumChunkActorsSpawned++;
+    }
+    return NewChunk;
+}
+
+void AVoxelWorldManager::ReleaseChunkActor(AVoxelChunk* Chunk)
+{
+    if (!IsValid(Chunk)) return;
+    
+    Chunk->ResetForPool();
+    ChunkPool.Add(Chunk);
+}
+
+void AVoxelWorldManager::LoadChunk(int32 ChunkX, int32 ChunkY)
+{
+    AVoxelChunk* NewChunk = AcquireChunkActor();
     
     if (NewChunk)
     {
-        NewChunk->InitializeChunk(ChunkX, ChunkY);
-        ActiveChunks.Add(FIntPoint(ChunkX, ChunkY), NewChunk);
+        // Недавно посещённый чанк берёт данные из хранилища вместе с правками игрока
+        const FIntPoint Key(ChunkX, ChunkY);
+        bool bCreated = false;
+        const FVoxelChunkDataRef ChunkData = ChunkStore.Acquire(Key, bCreated);
+
+        // Чанка нет в памяти — сохранённая копия с диска предпочтительнее генерации из шума
+        bool bGenerate = bCreated;
+        if (bCreated && RegionStorage && RegionStorage->LoadChunk(Key, *ChunkData))
+        {
+            bGenerate = false;
+        }
+        
+        // LOD до первой сборки, чтобы дальний чанк не строился дважды
+        const FIntVector2 PlayerChunk = PlayerPawn ? WorldToChunkCoords(PlayerPawn->GetActorLocation()) : LastPlayerChunk;
+        UpdateChunkLOD(NewChunk, Key, PlayerChunk);
+        
+        NewChunk->InitializeChunk(ChunkX, ChunkY, ChunkData, bGenerate);
+        ActiveChunks.Add(Key, NewChunk);
+        BuildingChunks.Add(Key);
+        
+        // Данные взяты из хранилища — соседи могут закрыть грани на стыке уже сейчас
+        if (NewChunk->HasBlockData())
+        {
+            ChunkStore.UpdateBytes(Key);
+            OnChunkBlockDataChanged(Key, true);
+        }
     }
 }
 
@@ -146,9 +465,247 @@ void AVoxelWorldManager::UnloadChunk(int32 ChunkX, int32 ChunkY)
     FIntPoint Key(ChunkX, ChunkY);
     if (AVoxelChunk** ChunkPtr = ActiveChunks.Find(Key))
     {
-        if (*ChunkPtr) (*ChunkPtr)->Destroy();
+        // Генерация не успела закончиться — в хранилище пустые данные, их нельзя оставлять
+        const bool bHasBlockData = *ChunkPtr && (*ChunkPtr)->HasBlockData();
+        ReleaseChunkActor(*ChunkPtr);
         ActiveChunks.Remove(Key);
+        if (bHasBlockData)
+        {
+            ChunkStore.Release(Key);
+            // Соседи закрывали грани на стыке по нашим блокам — без нас там край мира
+            OnChunkBlockDataChanged(Key, false);
+        }
+        else
+        {
+            ChunkStore.Discard(Key);
+        }
+    }
+}
+
+// Соседу с блочным мешем нужны только наши столбцы вплотную к его граням;
+// поле плотности сглаженного меша читает весь фартук, включая углы
+static bool DoesNeighborMeshReadColumn(const AVoxelChunk* Neighbor, int32 NeighborLocalX, int32 NeighborLocalY)
+{
+    if (!FVoxelChunkApron::IsInApron(NeighborLocalX, NeighborLocalY)) return false;
+    if (Neighbor->bUseSmoothTerrain) return true;
+    
+    const bool bInsideX = NeighborLocalX >= 0 && NeighborLocalX < VoxelConstants::ChunkSizeX;
+    const bool bInsideY = NeighborLocalY >= 0 && NeighborLocalY < VoxelConstants::ChunkSizeY;
+    return (bInsideY && (NeighborLocalX == -1 || NeighborLocalX == VoxelConstants::ChunkSizeX)) ||
+           (bInsideX && (NeighborLocalY == -1 || NeighborLocalY == VoxelConstants::ChunkSizeY));
+}
+
+void AVoxelWorldManager::GatherChunkApron(const FIntPoint& Coords, FVoxelChunkApron& OutApron) const
+{
+    constexpr int32 SX = VoxelConstants::ChunkSizeX;
+    constexpr int32 SY = VoxelConstants::ChunkSizeY;
+    
+    const FVoxelChunkData* NeighborData[FVoxelChunkApron::NumSides] = {};
+    for (int32 Side = 0; Side < FVoxelChunkApron::NumSides; Side++)
+    {
+        const FIntPoint NeighborCoords = Coords + FVoxelChunkApron::GetSideOffset(Side);
+        const AVoxelChunk* Neighbor = GetChunkAt(NeighborCoords.X, NeighborCoords.Y);
+        if (Neighbor && Neighbor->HasBlockData())
+        {
+            NeighborData[Side] = &Neighbor->GetChunkData();
+            OutApron.PresentSides |= (uint8)(1u << Side);
+        }
+    }
+    if (OutApron.PresentSides == 0) return;
+    
+    for (int32 Y = -FVoxelChunkApron::PadLow; Y < SY + FVoxelChunkApron::PadHigh; Y++)
+    {
+        for (int32 X = -FVoxelChunkApron::PadLow; X < SX + FVoxelChunkApron::PadHigh; X++)
+        {
+            const int32 Side = FVoxelChunkApron::GetSideAt(X, Y);
+            if (Side == INDEX_NONE || !NeighborData[Side]) continue;
+            
+            const FIntPoint Offset = FVoxelChunkApron::GetSideOffset(Side);
+            const int32 Column = FVoxelChunkData::GetColumnIndex(X - Offset.X * SX, Y - Offset.Y * SY);
+            const int32 Index = FVoxelChunkApron::GetIndex(X, Y);
+            OutApron.SolidMasks[Index] = NeighborData[Side]->ColumnSolidMasks[Column];
+            OutApron.PlayerPlacedMasks[Index] = NeighborData[Side]->ColumnSolidMasks[Column] & NeighborData[Side]->ColumnEditMasks[Column];
+        }
+    }
+}
+
+void AVoxelWorldManager::OnChunkBlockDataChanged(const FIntPoint& Coords, bool bAvailable)
+{
+    for (int32 Side = 0; Side < FVoxelChunkApron::NumSides; Side++)
+    {
+        const FIntPoint NeighborCoords = Coords + FVoxelChunkApron::GetSideOffset(Side);
+        AVoxelChunk* Neighbor = GetChunkAt(NeighborCoords.X, NeighborCoords.Y);
+        if (!Neighbor || !Neighbor->HasBlockData()) continue;
+        
+        // Угловые соседи видны только полю плотности сглаженного меша
+        if (Side >= FVoxelChunkApron::NumFaceSides && !Neighbor->bUseSmoothTerrain) continue;
+        
+        // Сосед уже собирался с нужным фартуком (например, его сборка запущена позже нашей)
+        if (Neighbor->HasApronSide(FVoxelChunkApron::GetOppositeSide(Side)) == bAvailable) continue;
+        
+        Neighbor->MarkDirty();
+    }
+}
+
+void AVoxelWorldManager::MarkBorderNeighborsDirty(const FIntVector2& ChunkCoords, int32 LocalX, int32 LocalY)
+{
+    for (int32 Side = 0; Side < FVoxelChunkApron::NumSides; Side++)
+    {
+        const FIntPoint Offset = FVoxelChunkApron::GetSideOffset(Side);
+        AVoxelChunk* Neighbor = GetChunkAt(ChunkCoords.X + Offset.X, ChunkCoords.Y + Offset.Y);
+        if (!Neighbor || !Neighbor->HasBlockData()) continue;
+        
+        // Наш столбец в локальных координатах соседа
+        const int32 NeighborLocalX = LocalX - Offset.X * VoxelConstants::ChunkSizeX;
+        const int32 NeighborLocalY = LocalY - Offset.Y * VoxelConstants::ChunkSizeY;
+        if (DoesNeighborMeshReadColumn(Neighbor, NeighborLocalX, NeighborLocalY))
+        {
+            Neighbor->MarkDirty();
+        }
+    }
+}
+
+void AVoxelWorldManager::SaveWorld()
+{
+    if (!RegionStorage) return;
+
+    TArray<TPair<FIntPoint, FVoxelChunkData*>> ToSave;
+    ChunkStore.ForEach([&ToSave](const FIntPoint& Coords, const FVoxelChunkDataRef& Data)
+    {
+        if (Data->bNeedsSave)
+        {
+            ToSave.Emplace(Coords, &Data.Get());
+        }
+    });
+
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumSaved = RegionStorage->SaveChunks(ToSave);
+    UE_LOG(LogTemp, Log, TEXT("Voxel save: %d/%d chunks written to %s in %.1f ms"),
+           NumSaved, ToSave.Num(), *RegionStorage->GetDirectory(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    ChunkStore.Trim();
+}
+
+void AVoxelWorldManager::SaveEvictedChunks()
+{
+    TArray<TPair<FIntPoint, FVoxelChunkData*>> ToSave;
+    ChunkStore.GetUnsavedReleased(ToSave);
+
+    const double StartTime = FPlatformTime::Seconds();
+    const int32 NumSaved = ToSave.Num() > 0 ? RegionStorage->SaveChunks(ToSave) : 0;
+
+    // После ошибки записи следующая попытка откладывается вдвое дольше (до 32 интервалов),
+    // а не повторяется в каждом кадре
+    double Delay = EvictedSaveInterval;
+    if (NumSaved < ToSave.Num())
+    {
+        NumEvictedSaveFailures++;
+        Delay *= 1 << FMath::Min(NumEvictedSaveFailures, 5);
+        UE_LOG(LogTemp, Warning, TEXT("Voxel save: %d of %d evicted chunks could not be written, retry in %.0f s"),
+               ToSave.Num() - NumSaved, ToSave.Num(), Delay);
+    }
+    else
+    {
+        NumEvictedSaveFailures = 0;
+    }
+    NextEvictedSaveTime = GetWorld()->GetTimeSeconds() + Delay;
+    UE_LOG(LogTemp, Verbose, TEXT("Voxel save: %d evicted chunks written in %.1f ms"),
+           NumSaved, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    // Записанные чанки теперь можно вытеснить; не записанные остаются в памяти
+    ChunkStore.Trim();
+}
+
+void AVoxelWorldManager::LogMemoryStats() const
+{
+    SIZE_T PaletteBytes = 0;
+    SIZE_T LegacyBytes = 0;
+    SIZE_T SmallBlockBytes = 0;
+    int32 NumSmallBlocks = 0;
+    int32 NumUniformSections = 0;
+    int32 NumChunks = 0;
+    SIZE_T MeshBytes = 0;
+    int64 NumMeshVertices = 0;
+    int64 NumMeshIndices = 0;
+    
+    for (const auto& Pair : ActiveChunks)
+    {
+        if (!Pair.Value) continue;
+        MeshBytes += Pair.Value->GetMeshMemoryUsage();
+        NumMeshVertices += Pair.Value->GetMeshStats().NumVertices;
+        NumMeshIndices += Pair.Value->GetMeshStats().NumTriangles * 3;
+        PaletteBytes += Pair.Value->GetBlockMemoryUsage();
+        LegacyBytes += AVoxelChunk::GetLegacyBlockMemoryUsage();
+        SmallBlockBytes += Pair.Value->GetSmallBlockMemoryUsage();
+        NumSmallBlocks += Pair.Value->GetNumSmallBlocks();
+        NumUniformSections += Pair.Value->GetNumUniformSections();
+        NumChunks++;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Voxel memory: %d chunks, palette %.1f KB (%.1f KB/chunk), flat FName %.1f KB (%.1f KB/chunk), ratio %.1fx"),
+           NumChunks,
+           PaletteBytes / 1024.0, NumChunks > 0 ? PaletteBytes / 1024.0 / NumChunks : 0.0,
+           LegacyBytes / 1024.0, NumChunks > 0 ? LegacyBytes / 1024.0 / NumChunks : 0.0,
+           PaletteBytes > 0 ? (double)LegacyBytes / PaletteBytes : 0.0);
+    UE_LOG(LogTemp, Log, TEXT("Voxel memory: %d of %d sections uniform"),
+           NumUniformSections, NumChunks * VoxelConstants::NumSectionsZ);
+    UE_LOG(LogTemp, Log, TEXT("Voxel chunk store: %d chunks (%d loaded), %.1f of %.1f MB budget"),
+           ChunkStore.Num(), ChunkStore.GetNumInUse(),
+           ChunkStore.GetAllocatedSize() / (1024.0 * 1024.0), ChunkStore.GetBudgetBytes() / (1024.0 * 1024.0));
+    UE_LOG(LogTemp, Log, TEXT("Voxel heightmap cache: %d tiles, %.1f KB, %llu hits / %llu misses"),
+           HeightmapCache->Num(), HeightmapCache->GetAllocatedSize() / 1024.0,
+           HeightmapCache->GetNumHits(), HeightmapCache->GetNumMisses());
+    UE_LOG(LogTemp, Log, TEXT("Voxel memory: %d small blocks, %.1f KB (%.1f bytes/block)"),
+           NumSmallBlocks, SmallBlockBytes / 1024.0,
+           NumSmallBlocks > 0 ? (double)SmallBlockBytes / NumSmallBlocks : 0.0);
+    const SIZE_T UnpackedMeshBytes = NumMeshVertices * FVoxelPackedMesh::UnpackedVertexSize + NumMeshIndices * sizeof(int32);
+    UE_LOG(LogTemp, Log, TEXT("Voxel meshes: %lld vertices, packed %.1f KB (%.1f bytes/vertex with indices), unpacked %.1f KB, ratio %.1fx"),
+           NumMeshVertices, MeshBytes / 1024.0,
+           NumMeshVertices > 0 ? (double)MeshBytes / NumMeshVertices : 0.0,
+           UnpackedMeshBytes / 1024.0, MeshBytes > 0 ? (double)UnpackedMeshBytes / MeshBytes : 0.0);
+    UE_LOG(LogTemp, Log, TEXT("Voxel chunk actors: %d active, %d pooled, %d spawned, %d reused from pool"),
+           ActiveChunks.Num(), ChunkPool.Num(), NumChunkActorsSpawned, NumChunkActorsReused);
+}
+
+void AVoxelWorldManager::LogMeshStats() const
+{
+    FVoxelMeshStats Total;
+    int64 UnmergedVertices = 0;
+    int64 UnmergedTriangles = 0;
+    int32 NumChunks = 0;
+    int32 LODChunks[FVoxelChunkMesher::MaxLODLevel + 1] = {};
+    int64 LODTriangles[FVoxelChunkMesher::MaxLODLevel + 1] = {};
+    
+    for (const auto& Pair : ActiveChunks)
+    {
+        if (!Pair.Value) continue;
+        const FVoxelMeshStats& Stats = Pair.Value->GetMeshStats();
+        Total.NumBlockFaces += Stats.NumBlockFaces;
+        Total.NumBlockQuads += Stats.NumBlockQuads;
+        Total.NumVertices += Stats.NumVertices;
+        Total.NumTriangles += Stats.NumTriangles;
+        Total.NumBorderFacesCulled += Stats.NumBorderFacesCulled;
+        Total.NumSkirtTriangles += Stats.NumSkirtTriangles;
+        Total.NumSectionAllocations += Stats.NumSectionAllocations;
+        LODChunks[Stats.LODLevel]++;
+        LODTriangles[Stats.LODLevel] += Stats.NumTriangles;
+        UnmergedVertices += Stats.GetUnmergedVertices();
+        UnmergedTriangles += Stats.GetUnmergedTriangles();
+        NumChunks++;
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("Voxel meshes: %d chunks, %d faces -> %d quads, vertices %lld -> %d, triangles %lld -> %d"),
+           NumChunks, Total.NumBlockFaces, Total.NumBlockQuads,
+           UnmergedVertices, Total.NumVertices, UnmergedTriangles, Total.NumTriangles);
+    UE_LOG(LogTemp, Log, TEXT("Voxel meshes: %d border faces culled by neighbor aprons"), Total.NumBorderFacesCulled);
+    for (int32 LODLevel = 0; LODLevel <= FVoxelChunkMesher::MaxLODLevel; LODLevel++)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Voxel meshes: LOD %d: %d chunks, %lld triangles (%.0f per chunk)"),
+               LODLevel, LODChunks[LODLevel], LODTriangles[LODLevel],
+               LODChunks[LODLevel] > 0 ? (double)LODTriangles[LODLevel] / LODChunks[LODLevel] : 0.0);
     }
+    UE_LOG(LogTemp, Log, TEXT("Voxel meshes: %d LOD skirt triangles"), Total.NumSkirtTriangles);
+    UE_LOG(LogTemp, Log, TEXT("Voxel meshes: %d section array allocations in last builds (%.1f per remesh)"),
+           Total.NumSectionAllocations, NumChunks > 0 ? (double)Total.NumSectionAllocations / NumChunks : 0.0);
 }
 
 bool AVoxelWorldManager::RemoveBlockAtWorldPosition(const FVector& WorldPosition)
@@ -156,8 +713,9 @@ bool AVoxelWorldManager::RemoveBlockAtWorldPosition(const FVector& WorldPosition
     FIntVector SubBlockPos = WorldPosToSubBlock(WorldPosition);
     FIntVector2 ChunkCoords = WorldToChunkCoords(WorldPosition);
     
+    // Чанк ещё генерируется в фоне — править нечего
     AVoxelChunk* Chunk = GetChunkAt(ChunkCoords.X, ChunkCoords.Y);
-    if (!Chunk) return false;
+    if (!Chunk || !Chunk->HasBlockData()) return false;
     
     // Сначала пробуем удалить маленький блок
     if (Chunk->RemoveSmallBlock(SubBlockPos))
@@ -177,6 +735,7 @@ bool AVoxelWorldManager::RemoveBlockAtWorldPosition(const FVector& WorldPosition
     {
         Chunk->SetBlock(LocalX, LocalY, LocalZ, NAME_None);
         Chunk->MarkDirty();
+        MarkBorderNeighborsDirty(ChunkCoords, LocalX, LocalY);
         return true;
     }
     
@@ -188,8 +747,9 @@ bool AVoxelWorldManager::PlaceSmallBlockAtWorldPosition(const FVector& WorldPosi
     FIntVector SubBlockPos = WorldPosToSubBlock(WorldPosition);
     FIntVector2 ChunkCoords = WorldToChunkCoords(WorldPosition);
     
+    // Чанк ещё генерируется в фоне — править нечего
     AVoxelChunk* Chunk = GetChunkAt(ChunkCoords.X, ChunkCoords.Y);
-    if (!Chunk) return false;
+    if (!Chunk || !Chunk->HasBlockData()) return false;
     
     // Проверяем, не занята ли позиция мировым блоком
     FIntVector WorldBlockPos = WorldPosToWorldBlock(WorldPosition);
@@ -197,13 +757,12 @@ bool AVoxelWorldManager::PlaceSmallBlockAtWorldPosition(const FVector& WorldPosi
     int32 LocalY = WorldBlockPos.Y - ChunkCoords.Y * VoxelConstants::ChunkSizeY;
     int32 LocalZ = WorldBlockPos.Z;
     
-    if (!Chunk->GetBlock(LocalX, LocalY, LocalZ).IsNone())
+    if (Chunk->IsBlockSolid(LocalX, LocalY, LocalZ))
         return false;
     
-    if (Chunk->HasSmallBlockAt(SubBlockPos))
+    if (!Chunk->AddSmallBlock(SubBlockPos, BlockID))
         return false;
     
-    Chunk->AddSmallBlock(SubBlockPos, BlockID);
     Chunk->MarkDirty();
     return true;
 }
@@ -213,8 +772,9 @@ bool AVoxelWorldManager::PlaceLargeBlockAtWorldPosition(const FVector& WorldPosi
     FIntVector WorldBlockPos = WorldPosToWorldBlock(WorldPosition);
     FIntVector2 ChunkCoords = WorldToChunkCoords(WorldPosition);
     
+    // Чанк ещё генерируется в фоне — править нечего
     AVoxelChunk* Chunk = GetChunkAt(ChunkCoords.X, ChunkCoords.Y);
-    if (!Chunk) return false;
+    if (!Chunk || !Chunk->HasBlockData()) return false;
     
     int32 LocalX = WorldBlockPos.X - ChunkCoords.X * VoxelConstants::ChunkSizeX;
     int32 LocalY = WorldBlockPos.Y - ChunkCoords.Y * VoxelConstants::ChunkSizeY;
@@ -227,10 +787,12 @@ bool AVoxelWorldManager::PlaceLargeBlockAtWorldPosition(const FVector& WorldPosi
         return false;
     }
     
-    if (!Chunk->GetBlock(LocalX, LocalY, LocalZ).IsNone())
+    // Ячейка занята большим или маленькими блоками — проверка масок
+    if (Chunk->IsBlockSolid(LocalX, LocalY, LocalZ) || Chunk->HasSmallBlocksInCell(LocalX, LocalY, LocalZ))
         return false;
     
     Chunk->SetBlock(LocalX, LocalY, LocalZ, BlockID);
     Chunk->MarkDirty();
+    MarkBorderNeighborsDirty(ChunkCoords, LocalX, LocalY);
     return true;
 }
@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "VoxelChunkStore.h"
+#include "VoxelHeightmapCache.h"
+#include "VoxelRegionFile.h"
 #include "VoxelWorldManager.generated.h"
 
 class AVoxelChunk;
@@ -24,6 +27,68 @@ public:
     
     static AVoxelWorldManager* GetInstance() { return Instance; }
 
+    // Вывести в лог расход памяти на воксельные данные загруженных чанков
+    void LogMemoryStats() const;
+    
+    // Вывести в лог суммарную статистику мешей (и выигрыш от greedy meshing)
+    void LogMeshStats() const;
+
+    // Записать на диск все чанки с несохранёнными правками
+    void SaveWorld();
+
+    // Перестроить меш чанка в ближайшем кадре (вызывает AVoxelChunk::MarkDirty)
+    void QueueChunkRebuild(const FIntPoint& Coords) { DirtyChunks.Add(Coords); }
+
+    // Фартук для сборки чанка: пограничные столбцы соседей с готовыми блоками
+    void GatherChunkApron(const FIntPoint& Coords, FVoxelChunkApron& OutApron) const;
+
+    // Бюджет памяти на воксельные данные чанков, включая выгруженные (МБ).
+    // Выгруженные чанки сверх бюджета вытесняются — начиная с давно не посещённых.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Streaming", meta = (ClampMin = "1"))
+    int32 ChunkDataBudgetMB = 64;
+
+    // Время кадра на спавн чанков, выгрузку мешей и коллизию (мс). Остальное ждёт следующих кадров;
+    // чанки под игроком и вокруг него обрабатываются сверх бюджета, чтобы он не провалился.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Streaming", meta = (ClampMin = "0.1"))
+    float ChunkBuildBudgetMs = 4.0f;
+
+    // Насколько раньше грузятся чанки по направлению взгляда (в чанках расстояния)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Streaming", meta = (ClampMin = "0"))
+    float ViewDirectionPriority = 2.0f;
+
+    // Сколько акторов чанков создать в пуле заранее, в BeginPlay
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Streaming", meta = (ClampMin = "0"))
+    int32 ChunkPoolPrewarm = 64;
+
+    // Сколько тайлов высот (по одному на чанк) держать в кэше шума
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Streaming", meta = (ClampMin = "16"))
+    int32 HeightmapCacheTiles = FVoxelHeightmapCache::DefaultMaxTiles;
+
+    // С какого расстояния до игрока (в чанках, по большей из осей) сглаженные чанки строятся
+    // с шагом 2 блока; 0 — LOD выключен
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|LOD", meta = (ClampMin = "0"))
+    int32 LOD1Distance = 4;
+
+    // С какого расстояния — с шагом 4 блока; 0 — только первый уровень
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|LOD", meta = (ClampMin = "0"))
+    int32 LOD2Distance = 6;
+
+    // Общий кэш высот рельефа; ссылку можно держать из других потоков
+    const FVoxelHeightmapCacheRef& GetHeightmapCache() const { return HeightmapCache; }
+
+    // Сохранять правки мира в файлы регионов и загружать чанки оттуда вместо генерации
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Save")
+    bool bSaveWorld = true;
+
+    // Каталог сохранения: Saved/VoxelWorld/<WorldSaveName>
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Save")
+    FString WorldSaveName = TEXT("Default");
+
+    // Как часто записывать выгруженные чанки с правками, которые держат хранилище сверх бюджета (с).
+    // Запись пачкой переписывает каждый файл региона один раз на все его чанки.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voxel|Save", meta = (ClampMin = "0.1"))
+    float EvictedSaveInterval = 5.0f;
+
 protected:
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
@@ -34,16 +99,67 @@ private:
     UPROPERTY()
     TMap<FIntPoint, AVoxelChunk*> ActiveChunks;
     
+    // Данные чанков мира; переживают акторы, выгруженные по дальности
+    FVoxelChunkStore ChunkStore;
+
+    FVoxelHeightmapCacheRef HeightmapCache = MakeShared<FVoxelHeightmapCache, ESPMode::ThreadSafe>();
+
+    // Файлы регионов сохранения (nullptr, если bSaveWorld выключен)
+    TUniquePtr<FVoxelRegionStorage> RegionStorage;
+    // Время мира следующей записи вытесняемых чанков; после неудачных записей интервал растёт
+    double NextEvictedSaveTime = 0.0;
+    int32 NumEvictedSaveFailures = 0;
+    // Записать выгруженные чанки с правками, чтобы хранилище могло их вытеснить
+    void SaveEvictedChunks();
+    
     UPROPERTY()
     APawn* PlayerPawn;
     
     FIntVector2 LastPlayerChunk;
     
+    // Чанки в радиусе без актора; порядок загрузки задаёт GetChunkPriority
+    TArray<FIntPoint> PendingLoads;
+    
+    // Выгруженные акторы чанков: скрыты, без коллизии и данных, ждут новых координат.
+    // Спавн актора с UVoxelChunkMeshComponent и его уничтожение (со сборкой мусора)
+    // дороже, чем переинициализация.
+    UPROPERTY()
+    TArray<AVoxelChunk*> ChunkPool;
+    int32 NumChunkActorsSpawned = 0;
+    int32 NumChunkActorsReused = 0;
+    
+    // Чанки с правками, ждущие перестройки; несколько правок за кадр дают одну сборку
+    TSet<FIntPoint> DirtyChunks;
+    // Чанки с запущенной фоновой сборкой — только их проверяет ProcessChunkQueue
+    TSet<FIntPoint> BuildingChunks;
+    void ProcessDirtyChunks();
+    
     void UpdateChunks();
+    // Спавн из очереди и применение готовых сборок в пределах ChunkBuildBudgetMs
+    void ProcessChunkQueue();
+    // Меньше — раньше: расстояние до игрока в чанках минус бонус за направление взгляда
+    float GetChunkPriority(const FIntPoint& Coords) const;
+    // Чанк игрока и соседние — обрабатываются вне бюджета
+    bool IsChunkUrgent(const FIntPoint& Coords) const;
+    
+    // LOD чанка по расстоянию до чанка игрока (LOD1Distance / LOD2Distance)
+    int32 GetChunkLOD(const FIntPoint& Coords, const FIntVector2& PlayerChunk) const;
+    // Выставить чанку LOD и юбки (если LOD соседа по грани другой); смена ставит его на перестройку
+    void UpdateChunkLOD(AVoxelChunk* Chunk, const FIntPoint& Coords, const FIntVector2& PlayerChunk) const;
+    
+    // Блоки чанка появились (bAvailable) или выгружены: перестроить соседей,
+    // чей последний меш собран без учёта этого изменения
+    void OnChunkBlockDataChanged(const FIntPoint& Coords, bool bAvailable);
+    // Правка большого блока у границы чанка меняет фартук соседей, которые читают этот столбец
+    void MarkBorderNeighborsDirty(const FIntVector2& ChunkCoords, int32 LocalX, int32 LocalY);
     FIntVector2 WorldToChunkCoords(const FVector& WorldPosition) const;
     AVoxelChunk* GetChunkAt(int32 ChunkX, int32 ChunkY) const;
     void LoadChunk(int32 ChunkX, int32 ChunkY);
     void UnloadChunk(int32 ChunkX, int32 ChunkY);
+    
+    // Свободный актор из пула или новый, если пул пуст
+    AVoxelChunk* AcquireChunkActor();
+    void ReleaseChunkActor(AVoxelChunk* Chunk);
     bool IsChunkInRange(int32 ChunkX, int32 ChunkY, const FIntVector2& PlayerChunk) const;
     
     FIntVector WorldPosToWorldBlock(const FVector& WorldPosition) const;